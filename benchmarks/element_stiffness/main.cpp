@@ -0,0 +1,93 @@
+#include <bso/structural_design/fea.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/*
+ * Measures the time it takes to derive the element stiffness matrix of each
+ * element type, and the time it takes to update the density and compute the
+ * response of an element afterwards. Usage: ./element_stiffness [repetitions]
+ */
+
+namespace sd = bso::structural_design;
+
+template <class FUNCTION>
+double timePerCall(const unsigned long& repetitions, FUNCTION f)
+{ // returns the average time per call of f in microseconds
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long i = 0; i < repetitions; ++i) f(i);
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::micro>(end-start).count()/repetitions;
+}
+
+template <class ELEMENT_GENERATOR>
+void benchmark(const std::string& name, const unsigned long& repetitions,
+							 std::vector<sd::element::node*>& nodes, ELEMENT_GENERATOR generate)
+{
+	double checkSum = 0.0;
+	double deriveTime = timePerCall(repetitions,[&](const unsigned long& i)
+	{
+		sd::element::element* e = generate(i);
+		checkSum += e->getVolume();
+		delete e;
+	});
+
+	sd::element::load_case lc("load");
+	sd::element::element* e = generate(0);
+	unsigned long DOFCount = 0;
+	for (auto& i : nodes) i->generateNFT(DOFCount);
+	Eigen::MatrixXd displacements = Eigen::MatrixXd::Constant(DOFCount,1,1e-3);
+	for (auto& i : nodes) i->addDisplacements(displacements,{lc});
+	e->generateEFT();
+	double responseTime = timePerCall(repetitions,[&](const unsigned long& i)
+	{
+		e->updateDensity(0.5 + 0.5*(i%2),3.0);
+		e->clearResponse();
+		e->computeResponse(lc);
+		checkSum += e->getTotalEnergy();
+	});
+	delete e;
+
+	std::cout << std::setw(18) << name << std::setw(20) << std::fixed << std::setprecision(2)
+						<< deriveTime << std::setw(22) << responseTime
+						<< "   (" << std::scientific << std::setprecision(3) << checkSum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long repetitions = 100000;
+	if (argc > 1) repetitions = std::stoul(argv[1]);
+
+	std::vector<sd::element::node*> nodes;
+	unsigned long ID = 0;
+	for (const auto& i : {std::vector<double>({0,0,0}),{1000,0,0},{1000,1000,0},{0,1000,0},
+												{0,0,1000},{1000,0,1000},{1000,1000,1000},{0,1000,1000}})
+	{
+		nodes.push_back(new sd::element::node({i[0],i[1],i[2]},ID++));
+	}
+
+	std::cout << std::setw(18) << "element" << std::setw(20) << "derive SM (us)"
+						<< std::setw(22) << "update + resp. (us)" << std::endl;
+	std::vector<sd::element::node*> l = {nodes[0],nodes[6]};
+	benchmark("truss",repetitions,l,[&](const unsigned long& i)
+	{
+		return new sd::element::truss(i,3e4,22500,l);
+	});
+	benchmark("beam",repetitions,l,[&](const unsigned long& i)
+	{
+		return new sd::element::beam(i,3e4,150,150,0.3,l);
+	});
+	l = {nodes[0],nodes[1],nodes[6],nodes[7]};
+	benchmark("flat_shell",repetitions,l,[&](const unsigned long& i)
+	{
+		return new sd::element::flat_shell(i,3e4,150,0.3,l);
+	});
+	benchmark("quad_hexahedron",repetitions,nodes,[&](const unsigned long& i)
+	{
+		return new sd::element::quad_hexahedron(i,3e4,0.3,nodes);
+	});
+
+	for (auto& i : nodes) delete i;
+	return 0;
+}
@@ -0,0 +1,43 @@
+#include <bso/spatial_design/ms_building.hpp>
+#include <bso/spatial_design/cf_building.hpp>
+#include <bso/structural_design/sd_model.hpp>
+#include <bso/grammar/grammar.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/*
+ * Measures the time it takes to mesh the structural design of the example
+ * building for a range of mesh sizes. Usage: ./mesh_time [maxMeshSize]
+ */
+
+int main(int argc, char* argv[])
+{
+	unsigned int maxMeshSize = 16;
+	if (argc > 1) maxMeshSize = std::stoi(argv[1]);
+
+	bso::spatial_design::ms_building MS("../../example/ms_input_file.txt");
+	bso::spatial_design::cf_building CF(MS);
+	bso::grammar::grammar gram(CF);
+	bso::structural_design::sd_model SD = gram.sd_grammar<bso::grammar::DEFAULT_SD_GRAMMAR>(
+		std::string("../../example/settings/sd_settings.txt"));
+
+	std::cout << std::setw(10) << "mesh size" << std::setw(12) << "nodes"
+						<< std::setw(12) << "elements" << std::setw(15) << "time (ms)" << std::endl;
+	for (unsigned int n = 1; n <= maxMeshSize; ++n)
+	{
+		auto start = std::chrono::steady_clock::now();
+		SD.mesh(n);
+		auto end = std::chrono::steady_clock::now();
+		double time = std::chrono::duration<double, std::milli>(end-start).count();
+
+		const auto& fem = SD.getFEA();
+		std::cout << std::setw(10) << n << std::setw(12) << fem->getNodes().size()
+							<< std::setw(12) << fem->getElements().size()
+							<< std::setw(15) << std::fixed << std::setprecision(1) << time
+							<< std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,79 @@
+#include <bso/structural_design/fea.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/*
+ * Measures the time of the stability check of fea (fea::isSingular) for
+ * square plates of n x n flat shell elements that are clamped at one edge,
+ * and compares it with the dense singular value decomposition for the
+ * smaller plates. Usage: ./singularity_check [maxElementsPerSide]
+ */
+
+namespace sd = bso::structural_design;
+
+void buildPlate(sd::fea& FEA, const unsigned int& n)
+{
+	double elementSize = 4000.0/n;
+	std::vector<sd::element::node*> nodes;
+	for (unsigned int i = 0; i <= n; ++i)
+	{
+		for (unsigned int j = 0; j <= n; ++j)
+		{
+			nodes.push_back(FEA.addNode({elementSize*i,elementSize*j,0}));
+		}
+	}
+	for (unsigned int j = 0; j <= n; ++j)
+	{
+		for (unsigned int k = 0; k < 6; ++k) nodes[j]->addConstraint(k);
+	}
+	nodes.back()->addLoad(sd::element::load(sd::element::load_case("load"),-1e3,2));
+	unsigned long ID = 0;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		for (unsigned int j = 0; j < n; ++j)
+		{
+			FEA.addElement(new sd::element::flat_shell(ID++,3e4,150,0.3,{nodes[(n+1)*i+j],
+				nodes[(n+1)*(i+1)+j],nodes[(n+1)*(i+1)+j+1],nodes[(n+1)*i+j+1]}));
+		}
+	}
+	FEA.generateGSM();
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int maxElementsPerSide = 64;
+	if (argc > 1) maxElementsPerSide = std::stoi(argv[1]);
+	const unsigned long maxDenseDOFs = 3000;
+
+	std::cout << std::setw(10) << "n" << std::setw(10) << "DOFs"
+						<< std::setw(18) << "sparse (ms)" << std::setw(18) << "dense SVD (ms)"
+						<< std::setw(15) << "cond" << std::endl;
+	for (unsigned int n = 2; n <= maxElementsPerSide; n *= 2)
+	{
+		sd::fea FEA;
+		buildPlate(FEA,n);
+
+		auto start = std::chrono::steady_clock::now();
+		double cond = FEA.estimateConditionNumber();
+		bool singular = FEA.isSingular();
+		auto end = std::chrono::steady_clock::now();
+		double sparseTime = std::chrono::duration<double, std::milli>(end-start).count()/2.0;
+
+		std::cout << std::setw(10) << n << std::setw(10) << FEA.getDOFCount()
+							<< std::setw(18) << std::fixed << std::setprecision(1) << sparseTime;
+		if (FEA.getDOFCount() <= maxDenseDOFs)
+		{
+			start = std::chrono::steady_clock::now();
+			Eigen::JacobiSVD<Eigen::MatrixXd> SVD(Eigen::MatrixXd(FEA.getGSM()));
+			end = std::chrono::steady_clock::now();
+			std::cout << std::setw(18) << std::chrono::duration<double, std::milli>(end-start).count();
+		}
+		else std::cout << std::setw(18) << "-";
+		std::cout << std::setw(15) << std::scientific << std::setprecision(2) << cond
+							<< (singular ? " (singular)" : "") << std::endl;
+	}
+
+	return 0;
+}
@@ -249,7 +249,11 @@ void bp_model::addState(state::state* s)
 		mStates.insert(mStates.begin(),s); // insert it at the beginning, so that these are updated before independent states are
 		mDependentStates.push_back(dynamic_cast<state::dependent_state*>(s));
 		
-		if 			(s->isSpace())  mSpaces.push_back( dynamic_cast<state::space* >(s));
+		if 			(s->isSpace())
+		{
+			mSpaces.push_back( dynamic_cast<state::space* >(s));
+			mSpaceTree.clear();
+		}
 		else if (s->isWall())   mWalls.push_back(  dynamic_cast<state::wall*  >(s));
 		else if (s->isFloor())  mFloors.push_back( dynamic_cast<state::floor* >(s));
 		else if (s->isWindow()) mWindows.push_back(dynamic_cast<state::window*>(s));
@@ -402,14 +406,34 @@ bp_results bp_model::getTotalResults()
 	return results;
 } // getTotalResults()
 
-bp_results bp_model::getPartialResults(bso::utilities::geometry::polyhedron* geom)
+void bp_model::mUpdateSpaceTree()
 {
-	bp_results results;
-	
-	for (const auto& i : mSpaces)
+	if (mSpaceTree.size() == mSpaces.size()) return;
+	Eigen::Matrix3Xd minCorners(3,mSpaces.size()), maxCorners(3,mSpaces.size());
+	for (unsigned long i = 0; i < mSpaces.size(); ++i)
+	{
+		Eigen::Vector3d min, max;
+		bso::utilities::bounding_box(*(mSpaces[i]->getGeometry()),min,max);
+		minCorners.col(i) = min;
+		maxCorners.col(i) = max;
+	}
+	mSpaceTree.build(minCorners,maxCorners);
+} // mUpdateSpaceTree()
+
+std::vector<unsigned long> bp_model::mSpacesInsideOrOn(
+	bso::utilities::geometry::polyhedron* geom) const
+{ // indices of the spaces of which all vertices are inside or on geom, expects an up to date space tree
+	// the tolerance of isInsideOrOn() is not a distance, so the box of geom is
+	// enlarged generously, the exact check decides for the candidates
+	Eigen::Vector3d min, max;
+	bso::utilities::bounding_box(*geom,min,max);
+	double margin = 1e-3 + 1e-2*(max-min).norm();
+	std::vector<unsigned long> candidates, spaces;
+	mSpaceTree.findContainedIn(min.array()-margin,max.array()+margin,candidates);
+	for (const auto& i : candidates)
 	{
 		bool allPointsInsideOrOn = true;
-		for (const auto& j : *(i->getGeometry()))
+		for (const auto& j : *(mSpaces[i]->getGeometry()))
 		{
 			if (!geom->isInsideOrOn(j))
 			{
@@ -417,14 +441,57 @@ bp_results bp_model::getPartialResults(bso::utilities::geometry::polyhedron* geo
 				break;
 			}
 		}
-		if (!allPointsInsideOrOn) continue;
-		
-		for (const auto& j : mSimulationPeriods)
+		if (allPointsInsideOrOn) spaces.push_back(i);
+	}
+	return spaces;
+} // mSpacesInsideOrOn()
+
+bp_results bp_model::getPartialResults(bso::utilities::geometry::polyhedron* geom)
+{
+	return this->getPartialResults(std::vector<bso::utilities::geometry::polyhedron*>({geom})).front();
+} // getPartialResults()
+
+std::vector<bp_results> bp_model::getPartialResults(
+	const std::vector<bso::utilities::geometry::polyhedron*>& geoms)
+{
+	this->mUpdateSpaceTree();
+	
+	// look up the energies of each space in each period once for all geometries
+	Eigen::MatrixXd heating = Eigen::MatrixXd::Zero(mSpaces.size(),mSimulationPeriods.size());
+	Eigen::MatrixXd cooling = Eigen::MatrixXd::Zero(mSpaces.size(),mSimulationPeriods.size());
+	unsigned long periodIndex = 0;
+	for (const auto& j : mSimulationPeriods)
+	{
+		auto heatingSearch = mHeatingEnergies.find(j.first);
+		auto coolingSearch = mCoolingEnergies.find(j.first);
+		for (unsigned long i = 0; i < mSpaces.size(); ++i)
 		{
-			results.mTotalHeatingEnergy += mHeatingEnergies[j.first][i];
-			results.mTotalCoolingEnergy += mCoolingEnergies[j.first][i];
-			results.mTotalEnergy				+= mHeatingEnergies[j.first][i];
-			results.mTotalEnergy				+= mCoolingEnergies[j.first][i];
+			if (heatingSearch != mHeatingEnergies.end())
+			{
+				auto spaceSearch = heatingSearch->second.find(mSpaces[i]);
+				if (spaceSearch != heatingSearch->second.end()) heating(i,periodIndex) = spaceSearch->second;
+			}
+			if (coolingSearch != mCoolingEnergies.end())
+			{
+				auto spaceSearch = coolingSearch->second.find(mSpaces[i]);
+				if (spaceSearch != coolingSearch->second.end()) cooling(i,periodIndex) = spaceSearch->second;
+			}
+		}
+		++periodIndex;
+	}
+	
+	std::vector<bp_results> results(geoms.size());
+	for (unsigned long k = 0; k < geoms.size(); ++k)
+	{
+		for (const auto& i : this->mSpacesInsideOrOn(geoms[k]))
+		{
+			for (unsigned long j = 0; j < mSimulationPeriods.size(); ++j)
+			{
+				results[k].mTotalHeatingEnergy += heating(i,j);
+				results[k].mTotalCoolingEnergy += cooling(i,j);
+				results[k].mTotalEnergy				 += heating(i,j);
+				results[k].mTotalEnergy				 += cooling(i,j);
+			}
 		}
 	}
 	
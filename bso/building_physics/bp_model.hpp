@@ -3,6 +3,7 @@
 
 #include <bso/building_physics/state_space_system.hpp>
 #include <bso/building_physics/state/states.hpp>
+#include <bso/utilities/aabb_tree.hpp>
 
 #include <vector>
 #include <string>
@@ -33,6 +34,7 @@ private:
 	
 	std::map<boost::posix_time::time_period,std::map<state::space*,double>>
 		mHeatingEnergies, mCoolingEnergies;
+	bso::utilities::aabb_tree mSpaceTree; // spatial index of mSpaces, built on the first region query
 	
 	double mInitialStateTemperatures = 0.0;
 	bool mIsInitialized = false;
@@ -43,6 +45,8 @@ private:
 	void mInitSystem();
 	void mPrintObserverHead(std::ostream& out);
 	void mPrintSystemState(std::ostream& out);
+	void mUpdateSpaceTree();
+	std::vector<unsigned long> mSpacesInsideOrOn(bso::utilities::geometry::polyhedron* geom) const;
 	
 	template <class STEPPER_TYPE>
 	void mSimulate(const boost::posix_time::time_period& period, std::ostream& out,
@@ -67,6 +71,7 @@ public:
 					
 	bp_results getTotalResults();
 	bp_results getPartialResults(bso::utilities::geometry::polyhedron* geom);
+	std::vector<bp_results> getPartialResults(const std::vector<bso::utilities::geometry::polyhedron*>& geoms);
 	
 	const state_space_system& getStateSpaceSystem() const {return mSystem;}
 	const unsigned int getNextDependentIndex() {return mDependentCount++;}
@@ -86,9 +86,13 @@ bso::structural_design::sd_model grammar::sd_grammar<DESIGN_RESPONSE>(
 		std::vector<bso::utilities::data_point> resultData;
 		// obtain design responses of substitute rectangles
 		int count = 0;
+		std::vector<bso::utilities::geometry::polygon*> subGeometries;
+		for (auto j : subRectangles) subGeometries.push_back(j.first);
+		auto sdResults = mSDModel.getPartialResults(subGeometries);
+		auto sdResultIte = sdResults.begin();
 		for (auto j : subRectangles)
 		{
-			auto sdResult = mSDModel.getPartialResults(j.first);
+			const auto& sdResult = *(sdResultIte++);
 			subResults[j.first] = sdResult;
 			resultData.push_back(bso::utilities::data_point({sdResult.mTotalStrainEnergy}));
 		}
@@ -38,6 +38,7 @@ namespace bso { namespace structural_design { namespace component {
 		mMeshedPoints.clear();
 		mElementPoints.clear();
 		mElements.clear();
+		mMeshGrid.clear();
 	} // clearMesh()
 	
 	void geometry::rescaleStructuralVolume(const double& scaleFactor)
@@ -5,6 +5,7 @@
 #include <bso/structural_design/component/load.hpp>
 #include <bso/structural_design/component/constraint.hpp>
 #include <bso/structural_design/component/point.hpp>
+#include <bso/structural_design/component/point_store.hpp>
 
 #include <bso/structural_design/element/elements.hpp>
 #include <initializer_list>
@@ -17,6 +18,9 @@ namespace bso { namespace structural_design { namespace component {
 		std::vector<point*> mMeshedPoints; // original + meshed points
 		std::vector<std::vector<point*> > mElementPoints; // meshed points per element
 		std::vector<element::element*> mElements; // elements meshed to the FE model
+		// number of mesh intervals in each direction, mMeshedPoints is a structured grid
+		// with point (i,j,k) at i + (n1+1)*j + (n1+1)*(n2+1)*k
+		std::vector<unsigned int> mMeshGrid;
 		
 		std::vector<structure> 	mStructures;
 		std::vector<load> 			mLoads;
@@ -38,7 +42,7 @@ namespace bso { namespace structural_design { namespace component {
 		virtual void addLoad(const load& l);
 		virtual void addConstraint(const constraint& c);
 
-		virtual void mesh(const unsigned int& n, std::vector<point*>& point_store) = 0;
+		virtual void mesh(const unsigned int& n, point_store& pointStore) = 0;
 		virtual void clearMesh();
 		
 		void rescaleStructuralVolume(const double& scaleFactor);
@@ -55,6 +59,7 @@ namespace bso { namespace structural_design { namespace component {
 		
 		const std::vector<point*>& getMeshedPoints() const {return mMeshedPoints;}
 		const std::vector<std::vector<point*> >& getElementPoints() const {return mElementPoints;}
+		const std::vector<unsigned int>& getMeshGrid() const {return mMeshGrid;}
 		const std::vector<element::element*>& getElements() const {return mElements;}
 		const std::vector<structure>& getStructures() const {return mStructures;} 
 		const std::vector<load>& getLoads() const {return mLoads;}
@@ -45,35 +45,19 @@ namespace bso { namespace structural_design { namespace component {
 		}
 	} // 
 
-	void line_segment::mesh(const unsigned int& n, std::vector<point*>& pointStore)
+	void line_segment::mesh(const unsigned int& n, point_store& pointStore)
 	{
 		bso::utilities::geometry::vector dirVector = mVertices[1] - mVertices[0];
 		
 		mMeshedPoints.clear();
 		mMeshedPoints.resize(n+1);
+		mMeshGrid = {n};
 
 		bso::utilities::geometry::vertex meshPoint;
-		unsigned long highestID = 0;
-		bool pointFound;
 		for (unsigned int i = 0; i < (n + 1); ++i)
 		{
 			meshPoint = mVertices[0] + (dirVector * ((double)i/((double)n)));
-			pointFound = false;
-			for (const auto& j : pointStore)
-			{
-				if (j->isSameAs(meshPoint))
-				{
-					mMeshedPoints[i] = j;
-					pointFound = true;
-					break;
-				}
-				if (highestID < j->getID()) highestID = j->getID();
-			}
-			if (!pointFound)
-			{
-				pointStore.push_back(new point(highestID++,meshPoint));
-				mMeshedPoints[i] = pointStore.back();
-			}
+			mMeshedPoints[i] = pointStore.addPoint(meshPoint);
 		}
 
 		// pair the points that define an element together
@@ -0,0 +1,44 @@
+#ifndef SD_POINT_STORE_CPP
+#define SD_POINT_STORE_CPP
+
+namespace bso { namespace structural_design { namespace component {
+	
+	point_store::point_store()
+	{
+		
+	} // ctor
+	
+	point_store::~point_store()
+	{
+		
+	} // dtor
+	
+	point* point_store::findPoint(const bso::utilities::geometry::vertex& p) const
+	{
+		unsigned long index;
+		if (mPointGrid.find(p,index)) return mPoints[index];
+		else return nullptr;
+	} // findPoint()
+	
+	point* point_store::addPoint(const bso::utilities::geometry::vertex& p)
+	{
+		point* existingPoint = this->findPoint(p);
+		if (existingPoint != nullptr) return existingPoint;
+		
+		mPoints.push_back(new point(mNextID++,p));
+		mPointGrid.insert(p);
+		return mPoints.back();
+	} // addPoint()
+	
+	void point_store::clear()
+	{
+		mPoints.clear();
+		mPointGrid.clear();
+		mNextID = 0;
+	} // clear()
+	
+} // namespace component
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_POINT_STORE_CPP
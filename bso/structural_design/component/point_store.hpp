@@ -0,0 +1,46 @@
+#ifndef SD_POINT_STORE_HPP
+#define SD_POINT_STORE_HPP
+
+#include <bso/structural_design/component/point.hpp>
+#include <bso/utilities/vertex_hash_grid.hpp>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace component {
+	
+	/*
+	 * Registry of the points that are shared by the meshes of all geometries.
+	 * Points are stored in order of insertion, and are looked up via a spatial
+	 * hash, a new point receives the ID following the highest ID in the store.
+	 * Like a std::vector<point*>, the store does not delete its points.
+	 */
+	
+	class point_store
+	{
+	private:
+		std::vector<point*> mPoints;
+		bso::utilities::vertex_hash_grid mPointGrid; // spatial index of mPoints
+		unsigned long mNextID = 0;
+	public:
+		point_store();
+		~point_store();
+		
+		point* findPoint(const bso::utilities::geometry::vertex& p) const;
+		point* addPoint(const bso::utilities::geometry::vertex& p);
+		void clear();
+		
+		unsigned long size() const {return mPoints.size();}
+		point* operator[](const unsigned long& index) const {return mPoints[index];}
+		point* back() const {return mPoints.back();}
+		std::vector<point*>::const_iterator begin() const {return mPoints.begin();}
+		std::vector<point*>::const_iterator end() const {return mPoints.end();}
+		const std::vector<point*>& getPoints() const {return mPoints;}
+	};
+	
+} // namespace component
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/component/point_store.cpp>
+
+#endif // SD_POINT_STORE_HPP
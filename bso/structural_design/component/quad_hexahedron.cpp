@@ -46,7 +46,7 @@ namespace bso { namespace structural_design { namespace component {
 		}
 	} // 
 
-	void quad_hexahedron::mesh(const unsigned int& n, std::vector<point*>& pointStore)
+	void quad_hexahedron::mesh(const unsigned int& n, point_store& pointStore)
 	{
 		this->mesh(0,1,2,n,n,n,pointStore);
 	} // 
@@ -54,10 +54,11 @@ namespace bso { namespace structural_design { namespace component {
 	void quad_hexahedron:: mesh(const unsigned int& v0Index,
 				const unsigned int& v1Index, const unsigned int& v2Index, 
 				const unsigned int& n1, const unsigned int& n2, const unsigned int& n3,
-				std::vector<point*>& pointStore)
+				point_store& pointStore)
 	{
 		mMeshedPoints.clear();
 		mMeshedPoints.resize((n1+1)*(n2+1)*(n3+1));
+		mMeshGrid = {n1, n2, n3};
 		namespace geom = bso::utilities::geometry;
 		std::vector<unsigned int> indices = {v0Index, v1Index, v2Index};
 
@@ -149,8 +150,6 @@ namespace bso { namespace structural_design { namespace component {
 
 		geom::vertex meshPoint;
 		geom::vector dirVector;
-		unsigned long highestID = 0;
-		bool pointFound;
 		for (unsigned int i = 0; i < (n1 + 1); ++i)
 		{
 			for (unsigned int j = 0; j < (n2 + 1); ++j)
@@ -160,22 +159,7 @@ namespace bso { namespace structural_design { namespace component {
 				for (unsigned int k = 0; k < (n3 + 1); ++k)
 				{
 					meshPoint = meshPointsQuad0154[i + ((n1+1)*j)] + (dirVector * ((double)k/((double)n3)));
-					pointFound = false;
-					for (const auto& l : pointStore)
-					{
-						if (l->isSameAs(meshPoint))
-						{
-							mMeshedPoints[i + ((n1+1)*j) + (((n1+1)*(n2+1))*k)] = l;
-							pointFound = true;
-							break;
-						}
-						if (highestID < l->getID()) highestID = l->getID();
-					}
-					if (!pointFound)
-					{
-						pointStore.push_back(new point(highestID++,meshPoint));
-						mMeshedPoints[i + ((n1+1)*j) + (((n1+1)*(n2+1))*k)] = pointStore.back();
-					}
+					mMeshedPoints[i + ((n1+1)*j) + (((n1+1)*(n2+1))*k)] = pointStore.addPoint(meshPoint);
 				}
 			}
 		}		
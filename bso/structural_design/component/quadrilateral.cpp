@@ -45,16 +45,17 @@ namespace bso { namespace structural_design { namespace component {
 		}
 	} // addStructure()
 
-	void quadrilateral::mesh(const unsigned int& n, std::vector<point*>& pointStore)
+	void quadrilateral::mesh(const unsigned int& n, point_store& pointStore)
 	{
 		this->mesh(0,1,n,n,pointStore);
 	} // mesh()
 	
 	void quadrilateral::mesh(const unsigned int& v0Index, const unsigned int& v1Index,
-				const unsigned int& n1, const unsigned int& n2, std::vector<point*>& pointStore)
+				const unsigned int& n1, const unsigned int& n2, point_store& pointStore)
 	{
 		mMeshedPoints.clear();
 		mMeshedPoints.resize((n1+1)*(n2+1));
+		mMeshGrid = {n1, n2};
 		namespace geom = bso::utilities::geometry;
 		std::vector<unsigned int> indices = {v0Index, v1Index};
 
@@ -96,30 +97,13 @@ namespace bso { namespace structural_design { namespace component {
 		
 		geom::vertex meshPoint;
 		geom::vector dirVector;
-		unsigned long highestID = 0;
-		bool pointFound;
 		for (unsigned int i = 0; i < (n1+1); ++i)
 		{
 			dirVector = meshPointsV32[i] - meshPointsV01[i];
 			for (unsigned int j = 0; j < (n2+1); ++j)
 			{
 				meshPoint = meshPointsV01[i] + (dirVector * ((double)j/((double)n2)));
-				pointFound = false;
-				for (const auto& k : pointStore)
-				{
-					if (k->isSameAs(meshPoint))
-					{
-						mMeshedPoints[i + (n2+1)*j] = k;
-						pointFound = true;
-						break;
-					}
-					if (highestID < k->getID()) highestID = k->getID();
-				}
-				if (!pointFound)
-				{
-					pointStore.push_back(new point(highestID++,meshPoint));
-					mMeshedPoints[i + (n2+1)*j] = pointStore.back();
-				}
+				mMeshedPoints[i + (n1+1)*j] = pointStore.addPoint(meshPoint);
 			}
 		}
 
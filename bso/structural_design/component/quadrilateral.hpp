@@ -18,10 +18,10 @@ namespace bso { namespace structural_design { namespace component {
 		~quadrilateral();
 		
 		void addStructure(const structure& s);
-		void mesh(const unsigned int& n, std::vector<point*>& pointStore);
+		void mesh(const unsigned int& n, point_store& pointStore);
 		void mesh(const unsigned int& v0Index, const unsigned int& v1Index,
 							const unsigned int& n1, const unsigned int& n2,
-							std::vector<point*>& pointStore);
+							point_store& pointStore);
 	};
 	
 } // namespace component
@@ -7,7 +7,7 @@
 namespace bso { namespace structural_design { namespace element {
 	
 	template<class CONTAINER>
-	void beam::deriveStiffnessMatrix(CONTAINER& l)
+	void beam::deriveStiffnessMatrix(CONTAINER& l, stiffness_cache* cache)
 	{
 		mIz = (mHeight * pow(mWidth, 3)) / 12.0;
 		mIy = (mWidth * pow(mHeight, 3)) / 12.0;
@@ -25,8 +25,16 @@ namespace bso { namespace structural_design { namespace element {
 			}
 		}
 		
+		stiffness_cache::signature signature;
+		if (cache != nullptr)
+		{ // congruent beams share their stiffness matrix
+			signature = cache->makeSignature("beam",{mE,mWidth,mHeight,mPoisson},mVertices);
+			if (cache->find(signature,mOriginalSM)) return;
+		}
+		
 		// create the transformation matrix (this contains the orientations of the beam)
-		mT.setZero(12,12);
+		stiffness_matrix T;
+		T.setZero();
 		bso::utilities::geometry::vector vx, vy, vz;
 		vx = this->getVector().normalized(); // the direction of the beam (local x-axis)
 		
@@ -52,12 +60,14 @@ namespace bso { namespace structural_design { namespace element {
 			for (int j = 0; j < 2; j++)
 			{ // and for both: displacements and rotations
 				// add the transformation term lambda
-				mT.block<3,3>((2*i+j)*3,(2*i+j)*3) = lambda.transpose();
+				T.block<3,3>((2*i+j)*3,(2*i+j)*3) = lambda.transpose();
 			}
 		}
 		
 		// initializing this element's stiffness matrix:
-		mSM.setZero(12,12);
+		auto originalSMPtr = std::make_shared<stiffness_matrix>();
+		stiffness_matrix& originalSM = *originalSMPtr;
+		originalSM.setZero();
 		double lenght = this->getLength();
 		double ael = (mA   * mE) / lenght; // normal strength
 		double gjl = (mG   * mJ) / lenght; // shear strength
@@ -70,69 +80,72 @@ namespace bso { namespace structural_design { namespace element {
 		double fy  = (2.0  * mE  * mIy) / lenght;
 		double fz  = (2.0  * mE  * mIz) / lenght;
 
-		mSM(0,0) = ael;   // row 0: F(x,1) : normal force
-		mSM(1,1) = az;    // row 1: F(y,1) : shear  force
-		mSM(2,2) = ay;    // row 2: F(z,1) : shear  force
-		mSM(3,3) = gjl;   // row 3: M(xy,1): torsional moment
-		mSM(4,2) = -cy;   // row 4: M(yz,1): bending   moment
-		mSM(4,4) = ey;
-		mSM(5,1) = cz;    // row 5: M(zx,1): bending   moment
-		mSM(5,5) = ez;
-		mSM(6,0) = -ael;  // row 6: F(x,2)
-		mSM(6,6) = ael;
-		mSM(7,1) = -az;   // row 7: F(y,2)
-		mSM(7,5) = -cz;
-		mSM(7,7) = az;
-		mSM(8,2) = -ay;   // row 8: F(z,2)
-		mSM(8,4) = cy;
-		mSM(8,8) = ay;
-		mSM(9,3) = -gjl;  // row 9: M(xy,2)
-		mSM(9,9) = gjl;
-		mSM(10,2) = -cy;  // row 10:M(yz,2)
-		mSM(10,4) = fy;
-		mSM(10,8) = cy;
-		mSM(10,10) = ey;
-		mSM(11,1) = cz;   // row 11:M(zx,2)
-		mSM(11,5) = fz;
-		mSM(11,7) = -cz;
-		mSM(11,11) = ez;
+		originalSM(0,0) = ael;   // row 0: F(x,1) : normal force
+		originalSM(1,1) = az;    // row 1: F(y,1) : shear  force
+		originalSM(2,2) = ay;    // row 2: F(z,1) : shear  force
+		originalSM(3,3) = gjl;   // row 3: M(xy,1): torsional moment
+		originalSM(4,2) = -cy;   // row 4: M(yz,1): bending   moment
+		originalSM(4,4) = ey;
+		originalSM(5,1) = cz;    // row 5: M(zx,1): bending   moment
+		originalSM(5,5) = ez;
+		originalSM(6,0) = -ael;  // row 6: F(x,2)
+		originalSM(6,6) = ael;
+		originalSM(7,1) = -az;   // row 7: F(y,2)
+		originalSM(7,5) = -cz;
+		originalSM(7,7) = az;
+		originalSM(8,2) = -ay;   // row 8: F(z,2)
+		originalSM(8,4) = cy;
+		originalSM(8,8) = ay;
+		originalSM(9,3) = -gjl;  // row 9: M(xy,2)
+		originalSM(9,9) = gjl;
+		originalSM(10,2) = -cy;  // row 10:M(yz,2)
+		originalSM(10,4) = fy;
+		originalSM(10,8) = cy;
+		originalSM(10,10) = ey;
+		originalSM(11,1) = cz;   // row 11:M(zx,2)
+		originalSM(11,5) = fz;
+		originalSM(11,7) = -cz;
+		originalSM(11,11) = ez;
 		
 		// m_SM is symmetric, so the above terms are mirrored
-		Eigen::MatrixXd tempSMCopy(12,12);
-		tempSMCopy = mSM.transpose();
+		stiffness_matrix tempSMCopy = originalSM.transpose();
 		tempSMCopy.diagonal().setZero();
-		mSM = tempSMCopy + mSM;
+		originalSM = tempSMCopy + originalSM;
 
 		// transform element stiffness matrix to global coordinate system
-		mSM = mT.transpose() * mSM * mT;
-		mOriginalSM = mSM;
+		originalSM = T.transpose() * originalSM * T;
+		
+		mOriginalSM = originalSMPtr;
+		if (cache != nullptr) cache->insert(signature,mOriginalSM);
 	}
 	
 	template<class CONTAINER>
 	beam::beam(const unsigned long& ID, const double& E, const double& width, const double& height, const double& poisson,
-						 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/)
+						 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/,
+						 stiffness_cache* cache /*= nullptr*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		fixed_size_element<12>(ID, E, ERelativeLowerBound)
 	{ // 
 		mIsBeam = true;
 		mWidth = width;
 		mHeight = height;
 		mPoisson = poisson;
 
-		this->deriveStiffnessMatrix(l);
+		this->deriveStiffnessMatrix(l, cache);
 	} // ctor
 	
 	beam::beam(const unsigned long& ID, const double& E, const double& width, const double& height, const double& poisson,
-						 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/)
+						 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/,
+						 stiffness_cache* cache /*= nullptr*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		fixed_size_element<12>(ID, E, ERelativeLowerBound)
 	{ // 
 		mIsBeam = true;
 		mWidth = width;
 		mHeight = height;
 		mPoisson = poisson;
 
-		this->deriveStiffnessMatrix(l);
+		this->deriveStiffnessMatrix(l, cache);
 	} // ctor
 	
 	beam::~beam()
@@ -6,7 +6,7 @@
 namespace bso { namespace structural_design { namespace element {
 	
 	class beam : public bso::utilities::geometry::line_segment,
-							 public element
+							 public fixed_size_element<12>
 	{
 	private:
 		double mWidth;
@@ -18,16 +18,15 @@ namespace bso { namespace structural_design { namespace element {
 		double mJ;
 		double mG;
 		
-		Eigen::MatrixXd mT;
-		
 		template<class CONTAINER>
-		void deriveStiffnessMatrix(CONTAINER& l);
+		void deriveStiffnessMatrix(CONTAINER& l, stiffness_cache* cache);
 	public:
 		template<class CONTAINER>
 		beam(const unsigned long& ID, const double& E, const double& width, const double& height, const double& poisson,
-				 CONTAINER& l, const double ERelativeLowerBound = 1e-6);
+				 CONTAINER& l, const double ERelativeLowerBound = 1e-6, stiffness_cache* cache = nullptr);
 		beam(const unsigned long& ID, const double& E, const double& width, const double& height, const double& poisson,
-				 std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6);
+				 std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6,
+				 stiffness_cache* cache = nullptr);
 		~beam();
 		
 		double getProperty(std::string var) const;
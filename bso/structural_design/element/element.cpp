@@ -18,8 +18,7 @@ namespace bso { namespace structural_design { namespace element {
 
 	void element::generateEFT()
 	{ //
-		mEFT.clear();unsigned int count = 0;
-		unsigned int localDOF = 0;
+		mEFT.clear();
 		for (const auto& i : mNodes)
 		{
 			for (unsigned int j = 0; j < 6; ++j)
@@ -36,7 +35,8 @@ namespace bso { namespace structural_design { namespace element {
 				{
 					try
 					{
-						if (i->getConstraint(j) == 0) mEFT[localDOF] = i->getGlobalDOF(j);
+						if (i->getConstraint(j) == 0) mEFT.push_back(i->getGlobalDOF(j));
+						else mEFT.push_back(-1);
 					}
 					catch (std::exception& e)
 					{
@@ -46,53 +46,32 @@ namespace bso { namespace structural_design { namespace element {
 												 << "\n(bso/structural_design/element.cpp)" << std::endl;
 						throw std::runtime_error(errorMessage.str());
 					}
-					++localDOF;
 				}
 			}
 		}
-	} //
-
-	std::vector<triplet> element::getSMTriplets() const
+	} // generateEFT()
+	
+	unsigned int element::addResponseLoadCase(const load_case& lc)
 	{ //
-		std::vector<triplet> tripletList;
-		for (unsigned int m = 0; m < mSM.rows(); ++m)
+		long lcIndex = this->findResponseLoadCase(lc);
+		if (lcIndex != -1) return lcIndex;
+		mLoadCases.push_back(lc);
+		mEnergies.push_back(0.0);
+		return mLoadCases.size() - 1;
+	} // addResponseLoadCase()
+	
+	long element::findResponseLoadCase(const load_case& lc) const
+	{ // there are only a few load cases, a linear search is faster than a map
+		for (unsigned int i = 0; i < mLoadCases.size(); ++i)
 		{
-			for (unsigned int n = 0; n < mSM.cols(); ++n)
-			{
-				if ((mSM(m,n) != 0) && (mEFT.find(m) != mEFT.end()) && (mEFT.find(n) != mEFT.end()))
-				{
-					tripletList.push_back(triplet(mEFT.at(m),mEFT.at(n),mSM(m,n))); // have to use map::at() because triplet initializer takes non const argument by reference
-				}
-			}
+			if (mLoadCases[i] == lc) return i;
 		}
-		return tripletList;
-	} //
-
-	void element::computeResponse(load_case lc)
-	{ //
-		Eigen::VectorXd elementDisplacements(mSM.rows());
-		elementDisplacements.setZero();
-		auto dispIte = elementDisplacements.data();
+		return -1;
+	} // findResponseLoadCase()
 
-		for (const auto& i : mNodes)
-		{
-			for (unsigned int j = 0; j < 6; ++j)
-			{
-				if (mEFS(j) == 1)
-				{
-					*dispIte = i->getDisplacements(lc)(j);
-					++dispIte;
-				}
-			}
-		}
-		mDisplacements[lc] = elementDisplacements;
-		mEnergies[lc] = 0.5 * elementDisplacements.transpose() * mSM * elementDisplacements;
-		mTotalEnergy += mEnergies[lc];
-	} //
-	
 	void element::clearResponse()
 	{ // 
-		mDisplacements.clear();
+		mLoadCases.clear();
 		mEnergies.clear();
 		mTotalEnergy = 0;
 	} // clearResponse()
@@ -103,13 +82,11 @@ namespace bso { namespace structural_design { namespace element {
 		{
 			mDensity = x;
 			mE = mEmin + std::pow(mDensity,penal)*(mE0 - mEmin);
-			mSM = (mE/mE0) * mOriginalSM;
 		}
 		else if (type == "regularSIMP")
 		{
 			mDensity = x;
 			mE = std::pow(mDensity,penal)*mE0;
-			mSM = (mE/mE0) * mOriginalSM;
 		}
 		else
 		{
@@ -153,6 +130,14 @@ namespace bso { namespace structural_design { namespace element {
 		throw std::runtime_error(errorMessage.str());
 	} // getStressSensitivityTermAE() gives error (standard) except for elements in which the function is over-written
 
+	Eigen::VectorXd element::getElementStressSensitivityTermAE(const double& /* alpha = 0 */) const
+	{
+		std::stringstream errorMessage;
+		errorMessage << "\nCannot call getElementStressSensitivityTermAE() for this element type\n"
+							<< "(bso/structural_design/element/element.cpp)" << std::endl;
+		throw std::runtime_error(errorMessage.str());
+	} // getElementStressSensitivityTermAE() gives error (standard) except for elements in which the function is over-written
+
 	Eigen::VectorXd element::getStressSensitivity(Eigen::MatrixXd& Lamda, const double& penal /* 1*/, const double& beta /* 1.0 / sqrt(3)*/) const
 	{
 		std::stringstream errorMessage;
@@ -163,9 +148,10 @@ namespace bso { namespace structural_design { namespace element {
 
 	const double& element::getEnergy(load_case lc, const std::string& type/*= ""*/) const
 	{ //
-		if (mEnergies.find(lc) != mEnergies.end())
+		long lcIndex = this->findResponseLoadCase(lc);
+		if (lcIndex != -1)
 		{
-			return mEnergies.find(lc)->second;
+			return mEnergies[lcIndex];
 		}
 		else
 		{
@@ -177,11 +163,12 @@ namespace bso { namespace structural_design { namespace element {
 		}
 	} //
 
-	const Eigen::VectorXd& element::getDisplacements(load_case lc) const
+	Eigen::VectorXd element::getDisplacements(load_case lc) const
 	{ //
-		if (mDisplacements.find(lc) != mDisplacements.end())
+		long lcIndex = this->findResponseLoadCase(lc);
+		if (lcIndex != -1)
 		{
-			return mDisplacements.find(lc)->second;
+			return mDisplacements.col(lcIndex);
 		}
 		else
 		{
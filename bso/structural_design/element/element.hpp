@@ -23,15 +23,16 @@ namespace bso { namespace structural_design { namespace element {
 		std::vector<node*> mNodes; // pointers to the nodes of this element
 		Eigen::Vector6i mEFS; // the freedom signature of that belongs to each node of this element
 
-		std::map<unsigned int, unsigned long> mEFT; // element freedom table, the global DOF indices of each DOF of this element's node
+		std::vector<long> mEFT; // element freedom table, the global DOF index of each DOF of this element, -1 if it is constrained
 		
-		Eigen::MatrixXd mOriginalSM; // the element stiffness matrix before applying topology densities
-		Eigen::MatrixXd mSM; // the element stiffness matrix after applying topology densities
-		
-		std::map<load_case, Eigen::VectorXd> mDisplacements;
-		std::map<load_case, double> mEnergies;
+		std::vector<load_case> mLoadCases; // the load cases of which the response has been computed, in order of computation
+		Eigen::MatrixXd mDisplacements; // one column per load case in mLoadCases, the storage is kept when the response is cleared
+		std::vector<double> mEnergies; // indexed as mLoadCases
 		double mTotalEnergy;
 		
+		unsigned int addResponseLoadCase(const load_case& lc); // returns the index of lc in mLoadCases, adds it if necessary
+		long findResponseLoadCase(const load_case& lc) const; // returns the index of lc in mLoadCases, -1 if not found
+		
 		// Variables related to the stiffness of this element, mostly related to topology optimization
 		double mDensity = 1.0; // element density
 		double mEmin; // the minimum youngs modulus [N/mm²]
@@ -51,8 +52,8 @@ namespace bso { namespace structural_design { namespace element {
 		virtual ~element();
 		
 		virtual void generateEFT();
-		virtual std::vector<triplet> getSMTriplets() const;
-		virtual void computeResponse(load_case lc);
+		virtual std::vector<triplet> getSMTriplets() const = 0;
+		virtual void computeResponse(load_case lc) = 0;
 		virtual void clearResponse();
 		
 		virtual void updateDensity(const double& x, const double& penal = 1, std::string type = "modifiedSIMP");
@@ -64,6 +65,7 @@ namespace bso { namespace structural_design { namespace element {
 		virtual double getVolumeSensitivity() const;
 		virtual double getStressAtCenter(const double& alpha = 0, const double& beta = 1.0 / sqrt(3)) const;
 		virtual Eigen::VectorXd getStressSensitivityTermAE(const unsigned long freeDOFs, const double& alpha = 0) const;
+		virtual Eigen::VectorXd getElementStressSensitivityTermAE(const double& alpha = 0) const; // indexed as the EFT
 		virtual Eigen::VectorXd getStressSensitivity(Eigen::MatrixXd& Lamda, const double& penal = 1, const double& beta = 1.0 / sqrt(3)) const;
 		virtual bso::utilities::geometry::vertex getCenter() const = 0;
 		
@@ -78,8 +80,12 @@ namespace bso { namespace structural_design { namespace element {
 		virtual bool& isActiveInCompliance() {return mActiveInCompliance;}
 		virtual const double& getDensity() const {return mDensity;}
 		virtual const double& getEnergy(load_case lc, const std::string& type = "") const;
-		virtual const Eigen::VectorXd& getDisplacements(load_case lc) const;
+		virtual Eigen::VectorXd getDisplacements(load_case lc) const;
 		const std::vector<node*>& getNodes() const {return mNodes;}
+		const std::vector<long>& getEFT() const {return mEFT;}
+		virtual Eigen::Map<const Eigen::MatrixXd> getOriginalSM() const = 0;
+		double getStiffnessFactor() const {return mE/mE0;} // the element stiffness matrix is this factor times getOriginalSM()
+		double getMinimumStiffnessFactor() const {return mEmin/mE0;} // the stiffness factor at zero density
 		
 	};
 	
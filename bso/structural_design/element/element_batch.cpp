@@ -0,0 +1,143 @@
+#ifndef SD_ELEMENT_BATCH_CPP
+#define SD_ELEMENT_BATCH_CPP
+
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace bso { namespace structural_design { namespace element {
+
+	template <int DOFS>
+	void element_batch::computeUnitEnergies(const group& g, const Eigen::MatrixXd& displacements,
+		Eigen::VectorXd& unitEnergies)
+	{
+		const unsigned int n = g.mDOFCount;
+		const unsigned long loadCaseCount = displacements.cols();
+		Eigen::Matrix<double, DOFS, 1> u, Ku;
+		u.resize(n);
+		Ku.resize(n);
+		for (unsigned long i = 0; i < g.mPositions.size(); ++i)
+		{
+			const long* DOFIndices = g.mDOFIndices.data() + i*n;
+			Eigen::Map<const Eigen::Matrix<double, DOFS, DOFS> > K(
+				g.mMatrices.data() + g.mMatrixIndices[i]*n*n, n, n);
+			double energy = 0.0;
+			for (unsigned long j = 0; j < loadCaseCount; ++j)
+			{
+				const double* U = displacements.col(j).data();
+				for (unsigned int k = 0; k < n; ++k)
+				{
+					u(k) = (DOFIndices[k] < 0) ? 0.0 : U[DOFIndices[k]];
+				}
+				Ku.noalias() = K * u;
+				energy += u.dot(Ku);
+			}
+			unitEnergies(g.mPositions[i]) = 0.5 * energy;
+		}
+	} // computeUnitEnergies()
+
+	element_batch::element_batch()
+	{
+
+	} // ctor()
+
+	element_batch::element_batch(const std::vector<element*>& elements)
+	{
+		this->build(elements);
+	} // ctor()
+
+	element_batch::~element_batch()
+	{
+
+	} // dtor()
+
+	void element_batch::build(const std::vector<element*>& elements)
+	{
+		mGroups.clear();
+		mMinimumStiffnessFactors.resize(elements.size());
+		mUnitEnergies.setZero(elements.size());
+		mEnergies.setZero(elements.size());
+		mSensitivities.setZero(elements.size());
+
+		std::unordered_map<unsigned int, unsigned long> groupIndices; // by DOF count
+		std::unordered_map<const double*, unsigned long> matrixIndices; // by stiffness matrix data
+		for (unsigned long i = 0; i < elements.size(); ++i)
+		{
+			const auto& ele = elements[i];
+			const auto& SM = ele->getOriginalSM();
+			const auto& EFT = ele->getEFT();
+			unsigned int DOFCount = SM.rows();
+			if (EFT.size() != DOFCount)
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nCannot add element " << ele->ID() << " to an element batch,\n"
+										 << "its element freedom table has not been generated.\n"
+										 << "(bso/structural_design/element/element_batch.cpp)" << std::endl;
+				throw std::runtime_error(errorMessage.str());
+			}
+
+			auto groupSearch = groupIndices.find(DOFCount);
+			if (groupSearch == groupIndices.end())
+			{
+				groupSearch = groupIndices.emplace(DOFCount, mGroups.size()).first;
+				mGroups.push_back(group());
+				mGroups.back().mDOFCount = DOFCount;
+			}
+			group& g = mGroups[groupSearch->second];
+
+			g.mPositions.push_back(i);
+			g.mDOFIndices.insert(g.mDOFIndices.end(), EFT.begin(), EFT.end());
+			auto matrixSearch = matrixIndices.find(SM.data());
+			if (matrixSearch == matrixIndices.end())
+			{ // congruent elements may share their stiffness matrix, pack it only once
+				matrixSearch = matrixIndices.emplace(SM.data(), g.mMatrices.size()/(DOFCount*DOFCount)).first;
+				g.mMatrices.insert(g.mMatrices.end(), SM.data(), SM.data() + DOFCount*DOFCount);
+			}
+			g.mMatrixIndices.push_back(matrixSearch->second);
+			mMinimumStiffnessFactors(i) = ele->getMinimumStiffnessFactor();
+		}
+	} // build()
+
+	void element_batch::compute(const Eigen::MatrixXd& displacements, const Eigen::VectorXd& densities,
+		const double& penal /*= 1*/)
+	{
+		if ((unsigned long)densities.size() != this->size())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot compute the energies of an element batch of size: " << this->size() << "\n"
+									 << "with a number of densities of: " << densities.size() << "\n"
+									 << "(bso/structural_design/element/element_batch.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+
+		for (const auto& g : mGroups)
+		{ // the common element sizes have fixed-size kernels
+			switch (g.mDOFCount)
+			{
+				case 6:  computeUnitEnergies<6>(g, displacements, mUnitEnergies); break;
+				case 12: computeUnitEnergies<12>(g, displacements, mUnitEnergies); break;
+				case 24: computeUnitEnergies<24>(g, displacements, mUnitEnergies); break;
+				default: computeUnitEnergies<Eigen::Dynamic>(g, displacements, mUnitEnergies); break;
+			}
+		}
+
+		// modified SIMP: E = Emin + x^p (E0 - Emin), the energy is E/E0 times the unit energy
+		auto x = densities.array();
+		auto rMin = mMinimumStiffnessFactors.array();
+		Eigen::ArrayXd xPenalMinusOne = x.pow(penal - 1);
+		mEnergies = (mUnitEnergies.array() * (rMin + x * xPenalMinusOne * (1 - rMin))).matrix();
+		mSensitivities = (-penal * mUnitEnergies.array() * xPenalMinusOne * (1 - rMin)).matrix();
+	} // compute()
+
+	unsigned long element_batch::matrixCount() const
+	{
+		unsigned long count = 0;
+		for (const auto& g : mGroups) count += g.mMatrices.size()/(g.mDOFCount*g.mDOFCount);
+		return count;
+	} // matrixCount()
+
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_ELEMENT_BATCH_CPP
@@ -0,0 +1,68 @@
+#ifndef SD_ELEMENT_BATCH_HPP
+#define SD_ELEMENT_BATCH_HPP
+
+#include <bso/structural_design/element/element.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace element {
+
+	/*
+	 * Evaluates the strain energies and the energy sensitivities of a set of
+	 * elements directly from the global displacements of an FEA system. The
+	 * elements are grouped by their number of DOFs. Each group stores the
+	 * global DOF indices of its elements and a packed array of their original
+	 * stiffness matrices, so an evaluation is a tight loop over fixed-size
+	 * element matrices without virtual calls or nodal lookups.
+	 * The batch must be built after the element freedom tables are generated,
+	 * i.e. after fea::generateGSM().
+	 */
+
+	class element_batch
+	{
+	private:
+		struct group
+		{ // elements with the same number of DOFs
+			unsigned int mDOFCount;
+			std::vector<unsigned long> mPositions; // position of each element in the batch
+			std::vector<long> mDOFIndices; // mDOFCount global DOF indices per element, -1 if constrained
+			std::vector<unsigned long> mMatrixIndices; // index of the stiffness matrix of each element
+			std::vector<double> mMatrices; // packed original stiffness matrices (column major), shared ones are stored once
+		};
+		std::vector<group> mGroups;
+
+		Eigen::VectorXd mMinimumStiffnessFactors; // Emin/E0 of each element
+		Eigen::VectorXd mUnitEnergies; // energy with the original stiffness matrix, summed over the load cases
+		Eigen::VectorXd mEnergies;
+		Eigen::VectorXd mSensitivities;
+
+		template <int DOFS>
+		static void computeUnitEnergies(const group& g, const Eigen::MatrixXd& displacements,
+			Eigen::VectorXd& unitEnergies);
+	public:
+		element_batch();
+		element_batch(const std::vector<element*>& elements);
+		~element_batch();
+
+		void build(const std::vector<element*>& elements);
+		// densities are the physical densities with which the elements were
+		// updated (modified SIMP), in the order of the elements in the batch
+		void compute(const Eigen::MatrixXd& displacements, const Eigen::VectorXd& densities,
+			const double& penal = 1);
+
+		unsigned long size() const {return mMinimumStiffnessFactors.size();}
+		unsigned long matrixCount() const; // number of packed stiffness matrices
+		const Eigen::VectorXd& getEnergies() const {return mEnergies;}
+		const Eigen::VectorXd& getEnergySensitivities() const {return mSensitivities;}
+		double getTotalEnergy() const {return mEnergies.sum();}
+	};
+
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/element/element_batch.cpp>
+
+#endif // SD_ELEMENT_BATCH_HPP
@@ -5,5 +5,6 @@
 #include <bso/structural_design/element/beam.hpp>
 #include <bso/structural_design/element/flat_shell.hpp>
 #include <bso/structural_design/element/quad_hexahedron.hpp>
+#include <bso/structural_design/element/element_batch.hpp>
 
 #endif // SD_ELEMENTS_HPP
\ No newline at end of file
@@ -0,0 +1,72 @@
+#ifndef SD_FIXED_SIZE_ELEMENT_CPP
+#define SD_FIXED_SIZE_ELEMENT_CPP
+
+namespace bso { namespace structural_design { namespace element {
+
+	template <int DOFS>
+	fixed_size_element<DOFS>::fixed_size_element(const unsigned long& ID, const double& E,
+																							 const double& ERelativeLowerBound /*=1e-6*/)
+	: element(ID, E, ERelativeLowerBound)
+	{ //
+		
+	} // ctor
+
+	template <int DOFS>
+	fixed_size_element<DOFS>::~fixed_size_element()
+	{ //
+		
+	} // dtor
+
+	template <int DOFS>
+	std::vector<triplet> fixed_size_element<DOFS>::getSMTriplets() const
+	{ //
+		std::vector<triplet> tripletList;
+		double stiffnessFactor = this->getStiffnessFactor();
+		const stiffness_matrix& originalSM = *mOriginalSM;
+		for (unsigned int m = 0; m < DOFS; ++m)
+		{
+			if (mEFT[m] < 0) continue;
+			for (unsigned int n = 0; n < DOFS; ++n)
+			{
+				if ((originalSM(m,n) != 0) && (mEFT[n] >= 0))
+				{
+					tripletList.push_back(triplet(mEFT[m],mEFT[n],stiffnessFactor*originalSM(m,n)));
+				}
+			}
+		}
+		return tripletList;
+	} // getSMTriplets()
+
+	template <int DOFS>
+	void fixed_size_element<DOFS>::computeResponse(load_case lc)
+	{ //
+		dof_vector elementDisplacements;
+		auto dispIte = elementDisplacements.data();
+
+		for (const auto& i : mNodes)
+		{
+			const auto& nodalDisplacements = i->getDisplacements(lc);
+			for (unsigned int j = 0; j < 6; ++j)
+			{
+				if (mEFS(j) == 1)
+				{
+					*dispIte = nodalDisplacements(j);
+					++dispIte;
+				}
+			}
+		}
+		unsigned int lcIndex = this->addResponseLoadCase(lc);
+		if (mDisplacements.rows() != DOFS || (unsigned int)mDisplacements.cols() <= lcIndex)
+		{
+			mDisplacements.conservativeResize(DOFS, lcIndex + 1);
+		}
+		mDisplacements.col(lcIndex) = elementDisplacements;
+		mEnergies[lcIndex] = 0.5 * this->getStiffnessFactor() * elementDisplacements.dot(*mOriginalSM * elementDisplacements);
+		mTotalEnergy += mEnergies[lcIndex];
+	} // computeResponse()
+
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_FIXED_SIZE_ELEMENT_CPP
@@ -0,0 +1,40 @@
+#ifndef SD_FIXED_SIZE_ELEMENT_HPP
+#define SD_FIXED_SIZE_ELEMENT_HPP
+
+#include <bso/structural_design/element/element.hpp>
+#include <bso/structural_design/element/stiffness_cache.hpp>
+
+#include <memory>
+
+namespace bso { namespace structural_design { namespace element {
+	
+	template <int DOFS>
+	class fixed_size_element : public element
+	{ // element of which the stiffness matrix has a size that is known at compile time (DOFS x DOFS)
+	protected:
+		// unaligned, so that derived elements can be stored in standard containers and allocated with new
+		typedef Eigen::Matrix<double, DOFS, DOFS, Eigen::DontAlign> stiffness_matrix;
+		typedef Eigen::Matrix<double, DOFS, 1, Eigen::DontAlign> dof_vector;
+		
+		// the element stiffness matrix before applying topology densities, see getStiffnessFactor(),
+		// it is shared by congruent elements that were derived with the same stiffness_cache
+		std::shared_ptr<const stiffness_matrix> mOriginalSM;
+		
+	public:
+		fixed_size_element(const unsigned long& ID, const double& E, const double& ERelativeLowerBound = 1e-6);
+		virtual ~fixed_size_element();
+		
+		virtual std::vector<triplet> getSMTriplets() const;
+		virtual void computeResponse(load_case lc);
+		
+		Eigen::Map<const Eigen::MatrixXd> getOriginalSM() const {return Eigen::Map<const Eigen::MatrixXd>(mOriginalSM->data(),DOFS,DOFS);}
+		bool sharesStiffnessWith(const fixed_size_element<DOFS>& rhs) const {return mOriginalSM == rhs.mOriginalSM;}
+	};
+	
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/element/fixed_size_element.cpp>
+
+#endif // SD_FIXED_SIZE_ELEMENT_HPP
@@ -1,10 +1,12 @@
 #ifndef SD_FLAT_SHELL_ELEMENT_HPP
 #define SD_FLAT_SHELL_ELEMENT_HPP
 
+#include <array>
+
 namespace bso { namespace structural_design { namespace element {
 	
 	class flat_shell : public bso::utilities::geometry::quadrilateral,
-										 public element
+										 public fixed_size_element<24>
 	{
 	private:
 		double mThickness;
@@ -14,27 +16,44 @@ namespace bso { namespace structural_design { namespace element {
 		double mAxialEnergy;
 		double mBendEnergy;
 		
-		Eigen::MatrixXd mSMNormal;
-		Eigen::MatrixXd mSMShear;
-		Eigen::MatrixXd mSMBending;
+		typedef Eigen::Matrix<double, 3, 8, Eigen::DontAlign> in_plane_B_matrix;
+		
+		struct stiffness_terms
+		{ // derived from the geometry, material and section only, shared by congruent flat shells
+			stiffness_matrix mOriginalSM;
+			stiffness_matrix mSMNormal;
+			stiffness_matrix mSMShear;
+			stiffness_matrix mSMBending;
+			
+			stiffness_matrix mT;
+			Eigen::Matrix3d mETermSolid; // 3x3 matrix with normal- and shear terms
+			in_plane_B_matrix mBAv; // average 3x8 (strain-displacement) matrix for in-plane behaviour
+		};
+		std::shared_ptr<const stiffness_terms> mTerms; // mOriginalSM points into these terms
 		
-		Eigen::MatrixXd mT;
-		Eigen::MatrixXd mETermSolid; // 3x3 matrix with normal- and shear terms
-		Eigen::MatrixXd mB1, mB2, mB3, mB4, mBAv; // 3x8 (strain-displacement) matrices for in-plane behaviour
+		struct gauss_point
+		{
+			double mWeight;
+			Eigen::Matrix<double, 2, 4> mDN; // derivatives of the bilinear shape functions to ksi (row 0) and eta (row 1)
+			Eigen::Matrix<double, 8, 2> mN; // derivatives of the quadratic shape functions for bending to ksi and eta
+		};
+		static const std::array<gauss_point, 4>& gaussPointTable(); // 2x2 integration points
 		
-		std::map<load_case, std::map<std::string, double>> mSeparatedEnergies;
-		Eigen::VectorXd melementDisp8DOF;
+		std::vector<Eigen::Vector3d> mSeparatedEnergies; // normal, shear and bending energy, indexed as mLoadCases
+		Eigen::Matrix<double, 8, 1, Eigen::DontAlign> melementDisp8DOF;
 		Eigen::Vector3d mStress;
-		Eigen::VectorXd mE0K0U;
+		dof_vector mE0K0U;
 		
 		template<class CONTAINER>
-		void deriveStiffnessMatrix(CONTAINER& l);
+		void deriveStiffnessMatrix(CONTAINER& l, stiffness_cache* cache);
 	public:
 		template<class CONTAINER>
 		flat_shell(const unsigned long& ID, const double& E, const double& thickness, const double& poisson,
-							 CONTAINER& l, const double ERelativeLowerBound = 1e-6, const double geomTol = 1e-3);
+							 CONTAINER& l, const double ERelativeLowerBound = 1e-6, const double geomTol = 1e-3,
+							 stiffness_cache* cache = nullptr);
 		flat_shell(const unsigned long& ID, const double& E, const double& thickness, const double& poisson,
-							 std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6, const double geomTol = 1e-3);
+							 std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6, const double geomTol = 1e-3,
+							 stiffness_cache* cache = nullptr);
 		~flat_shell();
 		
 		void computeResponse(load_case lc);
@@ -47,6 +66,7 @@ namespace bso { namespace structural_design { namespace element {
 		double getVolume() const;
 		double getStressAtCenter(const double& alpha = 0, const double& beta = 1.0 / sqrt(3)) const;
 		Eigen::VectorXd getStressSensitivityTermAE(const unsigned long freeDOFs, const double& alpha = 0) const;
+		Eigen::VectorXd getElementStressSensitivityTermAE(const double& alpha = 0) const;
 		Eigen::VectorXd getStressSensitivity(Eigen::MatrixXd& Lamda, const double& penal = 1, const double& beta = 1.0 / sqrt(3)) const;
 		bso::utilities::geometry::vertex getCenter() const;
 		Eigen::VectorXd getStress() {return mStress;} // for unit test
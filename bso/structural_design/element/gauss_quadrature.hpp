@@ -0,0 +1,18 @@
+#ifndef SD_GAUSS_QUADRATURE_HPP
+#define SD_GAUSS_QUADRATURE_HPP
+
+namespace bso { namespace structural_design { namespace element {
+namespace gauss_quadrature {
+
+	// two point Gauss-Legendre rule on [-1,1], used in each direction of the isoparametric elements
+	constexpr unsigned int pointCount = 2;
+	constexpr double points[pointCount]  = {-0.577350269189625764509148780502, // -1/sqrt(3)
+																						0.577350269189625764509148780502}; //  1/sqrt(3)
+	constexpr double weights[pointCount] = {1.0, 1.0};
+
+} // namespace gauss_quadrature
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_GAUSS_QUADRATURE_HPP
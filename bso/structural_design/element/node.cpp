@@ -7,7 +7,18 @@ namespace bso { namespace structural_design { namespace element {
 	{
 		mConstraints.setZero();
 		mNFS.setZero();
+		mNFT.fill(-1);
 	} // initializeVariables
+	
+	long node::findLoadCase(const std::vector<component::load_case>& loadCases,
+		const component::load_case& lc)
+	{ // there are only a few load cases, a linear search is faster than a map
+		for (unsigned int i = 0; i < loadCases.size(); ++i)
+		{
+			if (loadCases[i] == lc) return i;
+		}
+		return -1;
+	} // findLoadCase()
 
 	node::node(const std::initializer_list<double>&& l, const unsigned long& ID) :
 		bso::utilities::geometry::vertex(std::move(l))
@@ -54,46 +65,68 @@ namespace bso { namespace structural_design { namespace element {
 	
 	void node::addLoad(const load& l)
 	{ 
-		if (mLoads.find(l.loadCase()) == mLoads.end())
+		long lcIndex = findLoadCase(mLoadCases, l.loadCase());
+		if (lcIndex == -1)
 		{
 			this->addLoadCase(l.loadCase());
+			lcIndex = mLoads.size() - 1;
 		}
-		mLoads[l.loadCase()](l.DOF()) += l.magnitude();
+		mLoads[lcIndex](l.DOF()) += l.magnitude();
 
 	} //
 	
 	void node::addDisplacements(const std::map<component::load_case, Eigen::VectorXd>& displacements)
 	{
-		mDisplacements.clear();
+		this->clearDisplacements();
 		for (const auto& i : displacements)
 		{
 			Eigen::Vector6d tempDisplacements;
 			tempDisplacements.setZero();
 			for (unsigned int j = 0; j < 6; ++j)
 			{
-				if (mNFS(j) == 1 && mConstraints(j) == 0)
-				{
-					tempDisplacements(j) = i.second[mNFT[j]];
-				}
+				if (mNFT[j] >= 0) tempDisplacements(j) = i.second[mNFT[j]];
 			}
-			mDisplacements[i.first] = tempDisplacements;
+			mDisplacementLoadCases.push_back(i.first);
+			mDisplacements.push_back(tempDisplacements);
 		}
 	}
 	
+	void node::addDisplacements(const Eigen::MatrixXd& displacements,
+		const std::vector<component::load_case>& loadCases)
+	{
+		mDisplacementLoadCases = loadCases;
+		mDisplacements.resize(loadCases.size());
+		for (unsigned int i = 0; i < loadCases.size(); ++i)
+		{
+			for (unsigned int j = 0; j < 6; ++j)
+			{
+				mDisplacements[i](j) = (mNFT[j] >= 0) ? displacements(mNFT[j],i) : 0.0;
+			}
+		}
+	} // addDisplacements()
+	
 	void node::addLoadCase(load_case lc)
 	{
-		mLoads[lc] = Eigen::Vector6d::Zero();
+		long lcIndex = findLoadCase(mLoadCases, lc);
+		if (lcIndex != -1)
+		{
+			mLoads[lcIndex].setZero();
+			return;
+		}
+		mLoadCases.push_back(lc);
+		mLoads.push_back(Eigen::Vector6d::Zero());
 	} // addLoadCase()
 	
 	void node::clearDisplacements()
 	{ // 
+		mDisplacementLoadCases.clear();
 		mDisplacements.clear();
 	} // clearDisplacements()
 	
-	Eigen::Vector6d node::getDisplacements(component::load_case lc) const
+	const Eigen::Vector6d& node::getDisplacements(component::load_case lc) const
 	{
-		auto lcSearch = mDisplacements.find(lc);
-		if (lcSearch == mDisplacements.end())
+		long lcIndex = findLoadCase(mDisplacementLoadCases, lc);
+		if (lcIndex == -1)
 		{
 			std::stringstream errorMessage;
 			errorMessage << "\nError, could not access displacements for load case:\n"
@@ -102,13 +135,28 @@ namespace bso { namespace structural_design { namespace element {
 									 << "(bso/structural_design/element/node.cpp)" << std::endl;
 			throw std::runtime_error(errorMessage.str());
 		}
-		return lcSearch->second; 
+		return mDisplacements[lcIndex]; 
+	}
+	
+	const Eigen::Vector6d& node::getDisplacements(const unsigned int& lcIndex) const
+	{
+		if (lcIndex >= mDisplacements.size())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, could not access displacements for load case index:\n"
+									 << lcIndex << ", while the node has displacements for "
+									 << mDisplacements.size() << " load cases.\n"
+									 << "In node: " << *this << ".\n"
+									 << "(bso/structural_design/element/node.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		return mDisplacements[lcIndex];
 	}
 	
-	Eigen::Vector6d node::getLoads(component::load_case lc) const
+	const Eigen::Vector6d& node::getLoads(component::load_case lc) const
 	{
-		auto lcSearch = mLoads.find(lc);
-		if (lcSearch == mLoads.end())
+		long lcIndex = findLoadCase(mLoadCases, lc);
+		if (lcIndex == -1)
 		{
 			std::stringstream errorMessage;
 			errorMessage << "\nError, could not access loads for load case:\n"
@@ -117,7 +165,7 @@ namespace bso { namespace structural_design { namespace element {
 									 << "(bso/structural_design/element/node.cpp)" << std::endl;
 			throw std::runtime_error(errorMessage.str());
 		}
-		return lcSearch->second;
+		return mLoads[lcIndex];
 	}
 	
 	const int& node::getConstraint(const unsigned int& n) const
@@ -148,13 +196,6 @@ namespace bso { namespace structural_design { namespace element {
 		return mNFS[n];
 	}
 	
-	std::vector<component::load_case> node::getLoadCases() const
-	{
-		std::vector<component::load_case> temp;
-		for (auto& i : mLoads) temp.push_back(i.first);
-		return temp;
-	} // get LoadCases()
-	
 	void node::generateNFT(unsigned long& NFM)
 	{ // 
 		for (unsigned int i = 0; i < 6; ++i)
@@ -163,6 +204,7 @@ namespace bso { namespace structural_design { namespace element {
 			{
 				mNFT[i] = NFM++;
 			}
+			else mNFT[i] = -1;
 		}
 	} // generateNFT()
 	
@@ -185,23 +227,24 @@ namespace bso { namespace structural_design { namespace element {
 									 << "(bso/structural_design/element/node.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-		if (mNFT.find(localDOF) == mNFT.end())
+		if (mNFT[localDOF] < 0)
 		{
 			std::stringstream errorMessage;
 			errorMessage << "Error, could not find the global DOF from a node.\n"
 									 << "(bso/structural_design/element/node.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-		return mNFT.find(localDOF)->second;
+		return mNFT[localDOF];
 	} //
 	
 	bool node::checkLoad(component::load_case lc, const unsigned int& localDOF, double& load) const
 	{ 
 		if (mNFS(localDOF) == 1 && mConstraints(localDOF) == 0)
 		{
-			if (mLoads.find(lc) != mLoads.end())
+			long lcIndex = findLoadCase(mLoadCases, lc);
+			if (lcIndex != -1)
 			{
-				load = mLoads.find(lc)->second(localDOF);
+				load = mLoads[lcIndex](localDOF);
 				if (load != 0) return true;
 				else return false;
 			}
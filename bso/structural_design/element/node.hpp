@@ -6,8 +6,12 @@
 
 #include <Eigen/Dense>
 
+#include <Eigen/StdVector>
+
+#include <array>
 #include <map>
 #include <stdexcept>
+#include <vector>
 
 namespace Eigen {typedef Matrix<int, 6, 1> Vector6i;}
 namespace Eigen {typedef Matrix<double, 6, 1> Vector6d;}
@@ -18,13 +22,17 @@ namespace bso { namespace structural_design { namespace element {
 	{
 	private:
 		unsigned long mID;
-		std::map<unsigned int, unsigned long> mNFT; // nodal freedom table, contains the global indices of the node's DOFs
+		std::array<long, 6> mNFT; // nodal freedom table, contains the global index of each local DOF, -1 if it is inactive or constrained
 		Eigen::Vector6i mNFS; // nodal freedom signature, for each local DOF index, contains info if it is active or not
 		Eigen::Vector6i mConstraints; // constraints, for each local DOF index, contains if it is constrained or not
-		std::map<component::load_case, Eigen::Vector6d> mLoads; // indexe dby load case, contains for each local DOF index, the magnitude of the load
-		std::map<component::load_case, Eigen::Vector6d> mDisplacements; // indexed by load case, contains for each local DOF index, the magnitude of the displacement
+		std::vector<component::load_case> mLoadCases; // the load cases of mLoads, in order of insertion
+		std::vector<Eigen::Vector6d, Eigen::aligned_allocator<Eigen::Vector6d> > mLoads; // indexed as mLoadCases, contains for each local DOF index, the magnitude of the load
+		std::vector<component::load_case> mDisplacementLoadCases; // the load cases of mDisplacements, in the order they were added
+		std::vector<Eigen::Vector6d, Eigen::aligned_allocator<Eigen::Vector6d> > mDisplacements; // indexed as mDisplacementLoadCases, contains for each local DOF index, the magnitude of the displacement
 		
 		void initializeVariables();
+		static long findLoadCase(const std::vector<component::load_case>& loadCases,
+			const component::load_case& lc); // returns the index of lc in loadCases, -1 if not found
 	public:
 		node(const std::initializer_list<double>&& l, const unsigned long& ID); // initialize by initializer list
 		template<class T> node(const Eigen::MatrixBase<T>& rhs, const unsigned long& ID); // initialize by Eigen vector
@@ -34,18 +42,22 @@ namespace bso { namespace structural_design { namespace element {
 		void addConstraint(const unsigned int& localDOF); // adds a constraint to the local DOF
 		void addLoad(const load& l);
 		void addDisplacements(const std::map<component::load_case, Eigen::VectorXd>& displacements);
+		void addDisplacements(const Eigen::MatrixXd& displacements,
+			const std::vector<component::load_case>& loadCases); // one column of displacements per load case
 		void addLoadCase(load_case lc);
 		void clearDisplacements();
 
-		Eigen::Vector6d getDisplacements(component::load_case lc) const;
-		Eigen::Vector6d getLoads(component::load_case lc) const;
+		const Eigen::Vector6d& getDisplacements(component::load_case lc) const;
+		const Eigen::Vector6d& getDisplacements(const unsigned int& lcIndex) const; // by the index of the load case in the order they were added
+		const Eigen::Vector6d& getLoads(component::load_case lc) const;
 		const int& getConstraint(const unsigned int& n) const;
 		const int& getNFS(const unsigned int& n) const;
 		const unsigned long& ID() const {return mID;}
-		std::vector<component::load_case> getLoadCases() const;
+		const std::vector<component::load_case>& getLoadCases() const {return mLoadCases;}
 		
 		void generateNFT(unsigned long& NFM); // this will map the local DOFs to the global DOFs of this node
 		unsigned long getGlobalDOF(const unsigned int& localDOF) const;
+		const std::array<long, 6>& getNFT() const {return mNFT;}
 		
 		bool checkLoad(component::load_case lc, const unsigned int& localDOF, double& load) const;
 	};
@@ -1,30 +1,46 @@
 #ifndef SD_QUAD_HEXAHEDRON_ELEMENT_HPP
 #define SD_QUAD_HEXAHEDRON_ELEMENT_HPP
 
+#include <array>
+
 namespace bso { namespace structural_design { namespace element {
 	
 	class quad_hexahedron : public bso::utilities::geometry::quad_hexahedron,
-													public element
+													public fixed_size_element<24>
 	{
 	private:
 		double mPoisson;
 		
-		Eigen::MatrixXd mT;
-		Eigen::MatrixXd mETermSolid; // 6x6 matrix with normal- and shear elasticity terms
-		Eigen::MatrixXd mBSum, mBAv; // sum and average of strain-displacement matrices in each integration point
-		Eigen::VectorXd mDispLoc;
+		typedef Eigen::Matrix<double, 6, 24, Eigen::DontAlign> B_matrix;
+		
+		struct stiffness_terms
+		{ // derived from the geometry and material only, shared by congruent quad hexahedrons
+			stiffness_matrix mOriginalSM;
+			stiffness_matrix mT;
+			Eigen::Matrix<double, 6, 6, Eigen::DontAlign> mETermSolid; // 6x6 matrix with normal- and shear elasticity terms
+			B_matrix mBAv; // average of strain-displacement matrices in each integration point
+		};
+		std::shared_ptr<const stiffness_terms> mTerms; // mOriginalSM points into these terms
+		
+		struct gauss_point
+		{
+			double mWeight;
+			Eigen::Matrix<double, 3, 8> mDN; // derivatives of the shape functions to ksi, eta and zeta (rows)
+		};
+		static const std::array<gauss_point, 8>& gaussPointTable(); // 2x2x2 integration points
+		dof_vector mDispLoc;
 		Eigen::Vector6d mStress;
 
 		template<class CONTAINER>
-		void deriveStiffnessMatrix(CONTAINER& l);
+		void deriveStiffnessMatrix(CONTAINER& l, stiffness_cache* cache);
 	public:
 		template<class CONTAINER>
 		quad_hexahedron(const unsigned long& ID, const double& E, const double& poisson,
 										CONTAINER& l, const double ERelativeLowerBound = 1e-6,
-										const double geomTol = 1e-3);
+										const double geomTol = 1e-3, stiffness_cache* cache = nullptr);
 		quad_hexahedron(const unsigned long& ID, const double& E, const double& poisson,
 										std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6,
-										const double geomTol = 1e-3);
+										const double geomTol = 1e-3, stiffness_cache* cache = nullptr);
 		~quad_hexahedron();
 
 		void computeResponse(load_case lc);
@@ -34,6 +50,7 @@ namespace bso { namespace structural_design { namespace element {
 		bso::utilities::geometry::vertex getCenter() const;
 		double getStressAtCenter (const double& alpha = 0, const double& beta = 1.0 / sqrt(3)) const;
 		Eigen::VectorXd getStressSensitivityTermAE(const unsigned long freeDOFs, const double& alpha = 0) const;
+		Eigen::VectorXd getElementStressSensitivityTermAE(const double& alpha = 0) const;
 		Eigen::VectorXd getStressSensitivity(Eigen::MatrixXd& Lamda, const double& penal = 1, const double& beta = 1.0 / sqrt(3)) const;
 		Eigen::Vector6d getStress() {return mStress;} // for unit test
 	};
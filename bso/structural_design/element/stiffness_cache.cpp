@@ -0,0 +1,94 @@
+#ifndef SD_STIFFNESS_CACHE_CPP
+#define SD_STIFFNESS_CACHE_CPP
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace element {
+
+	bool stiffness_cache::signature::operator == (const signature& rhs) const
+	{
+		return mType == rhs.mType && mValues == rhs.mValues;
+	} // operator ==()
+
+	std::size_t stiffness_cache::signature_hash::operator()(const signature& s) const
+	{ // combine the hashes of the type and all values
+		std::size_t seed = std::hash<std::string>()(s.mType);
+		for (const auto& i : s.mValues)
+		{
+			seed ^= std::hash<long long>()(i) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		}
+		return seed;
+	} // operator()
+
+	stiffness_cache::stiffness_cache(const double& resolution) : mResolution(resolution)
+	{
+		if (!(mResolution > 0))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot initialize a stiffness cache with a resolution of: "
+									 << mResolution << "\n"
+									 << "(bso/structural_design/element/stiffness_cache.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+	} // ctor()
+
+	stiffness_cache::~stiffness_cache()
+	{
+
+	} // dtor()
+
+	template <class CONTAINER>
+	stiffness_cache::signature stiffness_cache::makeSignature(const std::string& type,
+		const std::vector<double>& properties, const CONTAINER& vertices) const
+	{
+		signature s;
+		s.mType = type;
+		for (const auto& i : properties)
+		{ // compare the properties bitwise
+			long long bits;
+			std::memcpy(&bits, &i, sizeof(double));
+			s.mValues.push_back(bits);
+		}
+		auto first = std::begin(vertices);
+		for (auto i = first; i != std::end(vertices); ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j)
+			{
+				s.mValues.push_back(std::llround(((*i)(j) - (*first)(j))/mResolution));
+			}
+		}
+		return s;
+	} // makeSignature()
+
+	template <class TERMS>
+	bool stiffness_cache::find(const signature& s, std::shared_ptr<const TERMS>& terms)
+	{
+		auto entrySearch = mEntries.find(s);
+		if (entrySearch == mEntries.end()) return false;
+		terms = std::static_pointer_cast<const TERMS>(entrySearch->second);
+		++mHitCount;
+		return true;
+	} // find()
+
+	template <class TERMS>
+	void stiffness_cache::insert(const signature& s, const std::shared_ptr<const TERMS>& terms)
+	{
+		mEntries[s] = terms;
+	} // insert()
+
+	void stiffness_cache::clear()
+	{
+		mEntries.clear();
+		mHitCount = 0;
+	} // clear()
+
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_STIFFNESS_CACHE_CPP
@@ -0,0 +1,64 @@
+#ifndef SD_STIFFNESS_CACHE_HPP
+#define SD_STIFFNESS_CACHE_HPP
+
+#include <bso/utilities/geometry/vertex.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace bso { namespace structural_design { namespace element {
+
+	/*
+	 * Stores the stiffness terms of elements by a signature of their type,
+	 * material and section properties, and the position of their vertices
+	 * relative to the first vertex. Elements with the same signature are
+	 * congruent (equal up to a translation) and can share their stiffness terms.
+	 * The relative positions are rounded to the resolution of the cache, the
+	 * properties are compared exactly.
+	 */
+
+	class stiffness_cache
+	{
+	public:
+		struct signature
+		{
+			std::string mType;
+			std::vector<long long> mValues;
+			bool operator == (const signature& rhs) const;
+		};
+	private:
+		struct signature_hash
+		{
+			std::size_t operator()(const signature& s) const;
+		};
+
+		double mResolution;
+		std::unordered_map<signature, std::shared_ptr<const void>, signature_hash> mEntries;
+		unsigned long mHitCount = 0;
+	public:
+		stiffness_cache(const double& resolution = 1e-6);
+		~stiffness_cache();
+
+		template <class CONTAINER>
+		signature makeSignature(const std::string& type, const std::vector<double>& properties,
+			const CONTAINER& vertices) const;
+		template <class TERMS>
+		bool find(const signature& s, std::shared_ptr<const TERMS>& terms); // the terms must have been inserted with the same type
+		template <class TERMS>
+		void insert(const signature& s, const std::shared_ptr<const TERMS>& terms);
+		void clear();
+
+		const double& getResolution() const {return mResolution;}
+		unsigned long size() const {return mEntries.size();}
+		unsigned long hitCount() const {return mHitCount;}
+	};
+
+} // namespace element
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/element/stiffness_cache.cpp>
+
+#endif // SD_STIFFNESS_CACHE_HPP
@@ -7,7 +7,7 @@
 namespace bso { namespace structural_design { namespace element {
 	
 	template<class CONTAINER>
-	void truss::deriveStiffnessMatrix(CONTAINER& l)
+	void truss::deriveStiffnessMatrix(CONTAINER& l, stiffness_cache* cache)
 	{
 		mEFS << 1,1,1,0,0,0; // the element freedom signature of each node of a truss (x,y,z,rx,ry,rz)
 		for (const auto& i : mVertices)
@@ -19,74 +19,87 @@ namespace bso { namespace structural_design { namespace element {
 			}
 		}
 
+		stiffness_cache::signature signature;
+		if (cache != nullptr)
+		{ // congruent trusses share their stiffness matrix
+			signature = cache->makeSignature("truss",{mE,mA},mVertices);
+			if (cache->find(signature,mOriginalSM)) return;
+		}
+
 		// initialising this elements stiffness matrix:
-		mSM.setZero(6,6);
+		auto originalSMPtr = std::make_shared<stiffness_matrix>();
+		stiffness_matrix& originalSM = *originalSMPtr;
+		originalSM.setZero();
 
 		// generate element stiffness matrix
 		bso::utilities::geometry::vector c = this->getVector().normalized();
 
 		// the geometric terms in the stiffness matrix ()
-		mSM(0,0) =  pow(c(0),2);
-		mSM(0,1) =  c(0)*c(1);
-		mSM(0,2) =  c(0)*c(2);
-		mSM(0,3) = -pow(c(0),2);
-		mSM(0,4) = -c(0)*c(1);
-		mSM(0,5) = -c(0)*c(2);
+		originalSM(0,0) =  pow(c(0),2);
+		originalSM(0,1) =  c(0)*c(1);
+		originalSM(0,2) =  c(0)*c(2);
+		originalSM(0,3) = -pow(c(0),2);
+		originalSM(0,4) = -c(0)*c(1);
+		originalSM(0,5) = -c(0)*c(2);
 
-		mSM(1,1) =  pow(c(1),2);
-		mSM(1,2) =  c(1)*c(2);
-		mSM(1,3) = -c(0)*c(1);
-		mSM(1,4) = -pow(c(1),2);
-		mSM(1,5) = -c(1)*c(2);
+		originalSM(1,1) =  pow(c(1),2);
+		originalSM(1,2) =  c(1)*c(2);
+		originalSM(1,3) = -c(0)*c(1);
+		originalSM(1,4) = -pow(c(1),2);
+		originalSM(1,5) = -c(1)*c(2);
 
-		mSM(2,2) =  pow(c(2),2);
-		mSM(2,3) = -c(0)*c(2);
-		mSM(2,4) = -c(1)*c(2);
-		mSM(2,5) = -pow(c(2),2);
+		originalSM(2,2) =  pow(c(2),2);
+		originalSM(2,3) = -c(0)*c(2);
+		originalSM(2,4) = -c(1)*c(2);
+		originalSM(2,5) = -pow(c(2),2);
 
-		mSM(3,3) =  pow(c(0),2);
-		mSM(3,4) =  c(0)*c(1);
-		mSM(3,5) =  c(0)*c(2);
+		originalSM(3,3) =  pow(c(0),2);
+		originalSM(3,4) =  c(0)*c(1);
+		originalSM(3,5) =  c(0)*c(2);
 
-		mSM(4,4) =  pow(c(1),2);
-		mSM(4,5) =  c(1)*c(2);
+		originalSM(4,4) =  pow(c(1),2);
+		originalSM(4,5) =  c(1)*c(2);
 
-		mSM(5,5) =  pow(c(2),2);
+		originalSM(5,5) =  pow(c(2),2);
 
-		mSM *= ((mA*mE) / this->getLength()); // relate the geometric terms to the stiffness of this element
+		originalSM *= ((mA*mE) / this->getLength()); // relate the geometric terms to the stiffness of this element
 
 		// m_SM is symmetric, this algorithm mirrors the above entries along the matrix diagonal
 		for (unsigned int i = 0; i < 6; ++i)
 		{
 			for (unsigned int j = i + 1; j < 6; ++j)
 			{
-				mSM(j,i) = mSM(i,j);
+				originalSM(j,i) = originalSM(i,j);
 			}
 		}
-		mOriginalSM = mSM;
+		
+		mOriginalSM = originalSMPtr;
+		if (cache != nullptr) cache->insert(signature,mOriginalSM);
 	}
 	
 	template<class CONTAINER>
 	truss::truss(const unsigned long& ID, const double& E, const double& A,
-							 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/)
+							 CONTAINER& l, const double ERelativeLowerBound /*= 1e-6*/,
+							 stiffness_cache* cache /*= nullptr*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		fixed_size_element<6>(ID, E, ERelativeLowerBound)
 	{ // 
 		mA = A;
 		mIsTruss = true;
 		
-		this->deriveStiffnessMatrix(l);
+		this->deriveStiffnessMatrix(l, cache);
 	} // ctor
 	
 	truss::truss(const unsigned long& ID, const double& E, const double& A,
-							 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/)
+							 std::initializer_list<node*>&& l, const double ERelativeLowerBound /*= 1e-6*/,
+							 stiffness_cache* cache /*= nullptr*/)
 	: bso::utilities::geometry::line_segment(derived_ptr_to_vertex(l)[0], derived_ptr_to_vertex(l)[1]),
-		element(ID, E, ERelativeLowerBound)
+		fixed_size_element<6>(ID, E, ERelativeLowerBound)
 	{ // 
 		mA = A;
 		mIsTruss = true;
 		
-		this->deriveStiffnessMatrix(l);
+		this->deriveStiffnessMatrix(l, cache);
 	} // ctor
 	
 	truss::~truss()
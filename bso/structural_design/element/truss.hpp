@@ -2,24 +2,25 @@
 #define SD_TRUSS_ELEMENT_HPP
 
 #include <bso/utilities/geometry/line_segment.hpp>
-#include <bso/structural_design/element/element.hpp>
+#include <bso/structural_design/element/fixed_size_element.hpp>
 
 namespace bso { namespace structural_design { namespace element {
 	
 	class truss : public bso::utilities::geometry::line_segment,
-							 public element
+							 public fixed_size_element<6>
 	{
 	private:
 		double mA; // surface area [mm³]
 		
 		template<class CONTAINER>
-		void deriveStiffnessMatrix(CONTAINER& l);
+		void deriveStiffnessMatrix(CONTAINER& l, stiffness_cache* cache);
 	public:
 		template<class CONTAINER>
 		truss(const unsigned long& ID, const double& E, const double& A,
-					CONTAINER& l, const double ERelativeLowerBound = 1e-6);
+					CONTAINER& l, const double ERelativeLowerBound = 1e-6, stiffness_cache* cache = nullptr);
 		truss(const unsigned long& ID, const double& E, const double& A,
-					std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6);
+					std::initializer_list<node*>&& l, const double ERelativeLowerBound = 1e-6,
+					stiffness_cache* cache = nullptr);
 		~truss();
 		
 		double getProperty(std::string var) const;
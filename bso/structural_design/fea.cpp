@@ -1,82 +1,211 @@
 #ifndef SD_FEA_CPP
 #define SD_FEA_CPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace bso { namespace structural_design {
 	
-	void fea::simplicialLLT()
+	Eigen::VectorXd element_results::typeMask(const element_type& type) const
 	{
-		mLLTSolver.compute(mGSM);
-		if (mLLTSolver.info() != Eigen::Success)
+		return (mTypes.array() == type).cast<double>().matrix();
+	} // typeMask()
+	
+	solver::direct_solver& fea::factorizeGSM(const std::string& solverName)
+	{
+		auto& directSolver = mDirectSolvers[solverName];
+		if (!directSolver)
+		{
+			directSolver.reset(solver::create_direct_solver(solverName));
+			mDirectSolverPatternCounts[solverName] = 0;
+		}
+		if (mDirectSolverPatternCounts[solverName] != mGSMPatternCount)
+		{ // the sparsity pattern changed, redo the ordering and symbolic factorization
+			directSolver->analyzePattern(mGSM);
+			mDirectSolverPatternCounts[solverName] = mGSMPatternCount;
+		}
+		directSolver->factorize(mGSM);
+		return *directSolver;
+	} // factorizeGSM()
+	
+	void fea::directSolve(const std::string& solverName)
+	{
+		auto directSolver = &(this->factorizeGSM(solverName));
+		if (directSolver->info() != Eigen::Success)
 		{
 			std::stringstream errorMessage;
-			errorMessage << "\nWhen solving an FEA system with SimplicialLLT,\n"
+			errorMessage << "\nWhen solving an FEA system with " << solverName << ",\n"
 									 << "Could not decompose the GSM\n"
 									 << "(bso/structural_design/fea.cpp)" << std::endl;
 			throw std::runtime_error(errorMessage.str());
 		}
 		
-		for (auto& lc : mLoadCases)
-		{
-			try
-			{
-				mDisplacements[lc] = mLLTSolver.solve(mLoads[lc]);
-				if (mLLTSolver.info() != Eigen::Success)
-				{
-					throw std::runtime_error("Solver failed");
-				}
-			}
-			catch (std::exception& e)
+		try
+		{ // solve all load cases at once
+			mDisplacements = directSolver->solve(mLoads);
+			if (directSolver->info() != Eigen::Success)
 			{
-				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with SimplicialLLT for load case: " << lc << "\n"
-										 << "received the following error:\n" << e.what() << "\n"
-										 << "(bso/structural_design/fea.cpp)" << std::endl;
-				throw std::runtime_error(errorMessage.str());
+				throw std::runtime_error("Solver failed");
 			}
 		}
-	} // simplicialLLT()
+		catch (std::exception& e)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving FEA system with " << solverName << "\n"
+									 << "received the following error:\n" << e.what() << "\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+	} // directSolve()
 	
-	void fea::simplicialLDLT()
+	void fea::PCG()
 	{
-		mLDLTSolver.compute(mGSM);
-		if (mLDLTSolver.info() != Eigen::Success)
+		if (mPCGPatternCount != mGSMPatternCount)
+		{ // the sparsity pattern changed, redo the ordering of the preconditioner
+			mPCGSolver.analyzePattern(mGSM);
+			mPCGPatternCount = mGSMPatternCount;
+			mPCGGuess.resize(0,0);
+		}
+		mPCGSolver.factorize(mGSM); // incomplete Cholesky, shared by all load cases
+		if (mPCGSolver.info() != Eigen::Success)
 		{
 			std::stringstream errorMessage;
-			errorMessage << "\nWhen solving an FEA system with SimplicialLDLT,\n"
-									 << "Could not decompose the GSM\n"
+			errorMessage << "\nWhen solving an FEA system with PCG,\n"
+									 << "Could not compute the incomplete Cholesky preconditioner\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		this->iterativeSolve(mPCGSolver, mPCGGuess, "PCG");
+	} // PCG()
+	
+	void fea::MGCG()
+	{
+		if (mMeshHierarchy.empty())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot solve an FEA system with MGCG without a mesh hierarchy,\n"
+									 << "see sd_model::setMultigridLevels().\n"
 									 << "(bso/structural_design/fea.cpp)" << std::endl;
 			throw std::runtime_error(errorMessage.str());
 		}
+		if (mMGCGPatternCount != mGSMPatternCount)
+		{ // the sparsity pattern changed, redo the prolongations
+			mMGCGSolver.preconditioner().setProlongations(this->generateProlongations());
+			mMGCGSolver.analyzePattern(mGSM);
+			mMGCGPatternCount = mGSMPatternCount;
+			mMGCGGuess.resize(0,0);
+		}
+		mMGCGSolver.factorize(mGSM); // the coarse operators, shared by all load cases
+		if (mMGCGSolver.info() != Eigen::Success)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving an FEA system with MGCG,\n"
+									 << "Could not decompose the GSM of the coarsest mesh\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		this->iterativeSolve(mMGCGSolver, mMGCGGuess, "MGCG");
+	} // MGCG()
+	
+	template <class ITERATIVE_SOLVER>
+	void fea::iterativeSolve(ITERATIVE_SOLVER& solver, Eigen::MatrixXd& guess, const std::string& solverName)
+	{
+		solver.setTolerance(mPCGTolerance);
+		solver.setMaxIterations(mDOFCount*10);
 		
-		for (auto& lc : mLoadCases)
+		bool warmStart = (guess.rows() == mLoads.rows() && guess.cols() == mLoads.cols());
+		mPCGIterations = 0;
+		for (unsigned int i = 0; i < mLoadCases.size(); ++i)
 		{
 			try
 			{
-				mDisplacements[lc] = mLDLTSolver.solve(mLoads[lc]);
-				if (mLDLTSolver.info() != Eigen::Success)
+				if (warmStart) mDisplacements.col(i) = solver.solveWithGuess(mLoads.col(i),guess.col(i));
+				else mDisplacements.col(i) = solver.solve(mLoads.col(i));
+				if (solver.info() != Eigen::Success)
 				{
-					throw std::runtime_error("Solver failed");
+					throw std::runtime_error("Solver did not converge");
 				}
+				mPCGIterations += solver.iterations();
 			}
 			catch (std::exception& e)
 			{
 				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with SimplicialLDLT for load case: " << lc << "\n"
+				errorMessage << "\nWhen solving FEA system with " << solverName << " for load case: " << mLoadCases[i] << "\n"
 										 << "received the following error:\n" << e.what() << "\n"
 										 << "(bso/structural_design/fea.cpp)" << std::endl;
 				throw std::runtime_error(errorMessage.str());
 			}
 		}
-	} // simplicialLDLT()
+		guess = mDisplacements;
+	} // iterativeSolve()
+	
+	std::vector<Eigen::SparseMatrix<double> > fea::generateProlongations() const
+	{ // a coarse node has the free DOFs of the node it coincides with
+		std::vector<std::array<long, 6> > fineDOFs(mNodes.size());
+		for (unsigned long i = 0; i < mNodes.size(); ++i) fineDOFs[i] = mNodes[i]->getNFT();
+		
+		std::vector<Eigen::SparseMatrix<double> > prolongations;
+		unsigned long fineDOFCount = mDOFCount;
+		for (const auto& transfer : mMeshHierarchy)
+		{
+			const auto& P = transfer.mProlongation;
+			if ((unsigned long)P.rows() != fineDOFs.size() ||
+					(unsigned long)P.cols() != transfer.mCoarseNodes.size())
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nMesh transfer " << prolongations.size() << " interpolates " << P.cols()
+										 << " to " << P.rows() << " nodes,\nexpected " << transfer.mCoarseNodes.size()
+										 << " to " << fineDOFs.size() << " nodes.\n"
+										 << "(bso/structural_design/fea.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+			
+			// number the free DOFs of the coarse nodes
+			std::vector<std::array<long, 6> > coarseDOFs(transfer.mCoarseNodes.size());
+			long coarseDOFCount = 0;
+			for (unsigned long i = 0; i < coarseDOFs.size(); ++i)
+			{
+				const auto& NFT = mNodes[transfer.mCoarseNodes[i]]->getNFT();
+				for (unsigned int k = 0; k < 6; ++k) coarseDOFs[i][k] = (NFT[k] >= 0) ? coarseDOFCount++ : -1;
+			}
+			
+			// each DOF is interpolated from the same DOF of the coarse nodes
+			std::vector<Eigen::Triplet<double> > triplets;
+			for (long j = 0; j < P.outerSize(); ++j)
+			{
+				for (Eigen::SparseMatrix<double>::InnerIterator it(P,j); it; ++it)
+				{
+					for (unsigned int k = 0; k < 6; ++k)
+					{
+						long fineDOF = fineDOFs[it.row()][k];
+						long coarseDOF = coarseDOFs[j][k];
+						if (fineDOF >= 0 && coarseDOF >= 0)
+						{
+							triplets.push_back(Eigen::Triplet<double>(fineDOF, coarseDOF, it.value()));
+						}
+					}
+				}
+			}
+			prolongations.push_back(Eigen::SparseMatrix<double>(fineDOFCount, coarseDOFCount));
+			prolongations.back().setFromTriplets(triplets.begin(), triplets.end());
+			
+			fineDOFs = std::move(coarseDOFs);
+			fineDOFCount = coarseDOFCount;
+		}
+		return prolongations;
+	} // generateProlongations()
 	
 	void fea::BiCGSTAB()
 	{
 		Eigen::BiCGSTAB<Eigen::SparseMatrix<double>, Eigen::DiagonalPreconditioner<double>> solver;
 		
-		for (auto& lc : mLoadCases)
+		for (unsigned int i = 0; i < mLoadCases.size(); ++i)
 		{
 			try
 			{
@@ -88,7 +217,7 @@ namespace bso { namespace structural_design {
 					throw std::runtime_error("Solver failed decompose matrix GSM");
 				}
 				
-				mDisplacements[lc] = solver.solve(mLoads[lc]);
+				mDisplacements.col(i) = solver.solve(mLoads.col(i));
 				if (solver.info() != Eigen::Success)
 				{
 					throw std::runtime_error("Solver failed to solve GSM for loads");
@@ -97,7 +226,7 @@ namespace bso { namespace structural_design {
 			catch (std::exception& e)
 			{
 				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with BiCGSTAB for load case: " << lc << "\n"
+				errorMessage << "\nWhen solving FEA system with BiCGSTAB for load case: " << mLoadCases[i] << "\n"
 										 << "received the following error:\n" << e.what() << "\n"
 										 << "(bso/structural_design/fea.cpp)" << std::endl;
 				throw std::runtime_error(errorMessage.str());
@@ -109,7 +238,7 @@ namespace bso { namespace structural_design {
 	{
 		Eigen::BiCGSTAB<Eigen::SparseMatrix<double>, Eigen::DiagonalPreconditioner<double>> solver;
 		
-		for (auto& lc : mLoadCases)
+		for (unsigned int i = 0; i < mLoadCases.size(); ++i)
 		{
 			try
 			{
@@ -120,7 +249,7 @@ namespace bso { namespace structural_design {
 				}
 				// get a rough solution
 				solver.setMaxIterations(3);
-				mDisplacements[lc] = solver.solve(mLoads[lc]);
+				mDisplacements.col(i) = solver.solve(mLoads.col(i));
 				
 				if (solver.info() != Eigen::Success)
 				{
@@ -128,7 +257,7 @@ namespace bso { namespace structural_design {
 				}
 				
 				// scale the GSM into a temporary GSM matrix: Could
-				Eigen::VectorXd wInverse = (mDisplacements[lc].array().abs()+1e-6).inverse();
+				Eigen::VectorXd wInverse = (mDisplacements.col(i).array().abs()+1e-6).inverse();
 				Eigen::SparseMatrix<double> C;
 				C.resize(mDOFCount,mDOFCount);
 				C = mGSM * wInverse.asDiagonal();
@@ -142,8 +271,8 @@ namespace bso { namespace structural_design {
 				}
 				
 				Eigen::VectorXd y(mDOFCount);
-				y = solver.solve(mLoads[lc]);
-				mDisplacements[lc] = wInverse.asDiagonal() * y;
+				y = solver.solve(mLoads.col(i));
+				mDisplacements.col(i) = wInverse.asDiagonal() * y;
 				if (solver.info() != Eigen::Success)
 				{
 					throw std::runtime_error("Solver failed to solver for y");
@@ -152,7 +281,7 @@ namespace bso { namespace structural_design {
 			catch (std::exception& e)
 			{
 				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving FEA system with scaled BiCGSTAB for load case: " << lc << "\n"
+				errorMessage << "\nWhen solving FEA system with scaled BiCGSTAB for load case: " << mLoadCases[i] << "\n"
 										 << "received the following error:\n" << e.what() << "\n"
 										 << "(bso/structural_design/fea.cpp)" << std::endl;
 				throw std::runtime_error(errorMessage.str());
@@ -160,6 +289,165 @@ namespace bso { namespace structural_design {
 		}
 	} // scaledBiCGSTAB()
 	
+	void fea::updateGSMPattern()
+	{
+		auto outerBegin = mGSM.outerIndexPtr();
+		auto outerEnd = outerBegin + mGSM.outerSize() + 1;
+		auto innerBegin = mGSM.innerIndexPtr();
+		auto innerEnd = innerBegin + mGSM.nonZeros();
+		
+		if (mGSMPatternCount > 0 &&
+				(unsigned long)mGSMOuterIndices.size() == (unsigned long)(outerEnd - outerBegin) &&
+				(unsigned long)mGSMInnerIndices.size() == (unsigned long)(innerEnd - innerBegin) &&
+				std::equal(outerBegin, outerEnd, mGSMOuterIndices.begin()) &&
+				std::equal(innerBegin, innerEnd, mGSMInnerIndices.begin()))
+		{ // same pattern as the previous GSM
+			return;
+		}
+		
+		mGSMOuterIndices.assign(outerBegin, outerEnd);
+		mGSMInnerIndices.assign(innerBegin, innerEnd);
+		++mGSMPatternCount;
+	} // updateGSMPattern()
+	
+	void fea::generateScatterMap()
+	{ // must be called directly after mGSM is created from the element triplets,
+		// densities only scale the element stiffness matrices so their nonzero
+		// pattern is that of the original stiffness matrices
+		mScatterOffsets.clear();
+		mScatterLocalIndices.clear();
+		mScatterGlobalIndices.clear();
+		mScatterOffsets.reserve(mElements.size()+1);
+		mScatterOffsets.push_back(0);
+		
+		auto outerIndices = mGSM.outerIndexPtr();
+		auto innerIndices = mGSM.innerIndexPtr();
+		for (const auto& i : mElements)
+		{ // visit the entries in the same order as getSMTriplets()
+			const auto& SM = i->getOriginalSM();
+			const auto& EFT = i->getEFT();
+			for (unsigned int m = 0; m < SM.rows(); ++m)
+			{
+				long row = EFT[m];
+				if (row < 0) continue;
+				for (unsigned int n = 0; n < SM.cols(); ++n)
+				{
+					if (SM(m,n) == 0) continue;
+					long col = EFT[n];
+					if (col < 0) continue;
+					
+					// find the slot of (row, col) in the column major storage of mGSM
+					auto colBegin = innerIndices + outerIndices[col];
+					auto colEnd = innerIndices + outerIndices[col+1];
+					auto slot = std::lower_bound(colBegin, colEnd, row);
+					if (slot == colEnd || *slot != row)
+					{
+						std::stringstream errorMessage;
+						errorMessage << "\nError, while generating the scatter map of the GSM.\n"
+												 << "Could not find entry (" << row << ", "
+												 << col << ") in the GSM.\n"
+												 << "(bso/structural_design/fea.cpp)" << std::endl;
+						throw std::runtime_error(errorMessage.str());
+					}
+					mScatterLocalIndices.push_back(m + n*SM.rows());
+					mScatterGlobalIndices.push_back(slot - innerIndices);
+				}
+			}
+			mScatterOffsets.push_back(mScatterLocalIndices.size());
+		}
+		mScatterMapInitialized = true;
+	} // generateScatterMap()
+	
+	void fea::scatterGSM()
+	{ // reassembles the values of mGSM, its sparsity pattern remains the same
+		Eigen::VectorXd stiffnessFactors(mElements.size());
+		for (unsigned long i = 0; i < mElements.size(); ++i)
+		{
+			stiffnessFactors(i) = mElements[i]->getStiffnessFactor();
+		}
+		this->scatterGSM(stiffnessFactors, mGSM.valuePtr());
+	} // scatterGSM()
+	
+	void fea::scatterGSM(const Eigen::VectorXd& stiffnessFactors, double* values) const
+	{ // values has the pattern of mGSM
+		std::fill(values, values + mGSM.nonZeros(), 0.0);
+		for (unsigned long i = 0; i < mElements.size(); ++i)
+		{
+			const double* SMData = mElements[i]->getOriginalSM().data();
+			double stiffnessFactor = stiffnessFactors(i);
+			for (unsigned long j = mScatterOffsets[i]; j < mScatterOffsets[i+1]; ++j)
+			{
+				values[mScatterGlobalIndices[j]] += stiffnessFactor*SMData[mScatterLocalIndices[j]];
+			}
+		}
+	} // scatterGSM()
+	
+	void fea::updateElementResults()
+	{
+		auto& r = mElementResults;
+		unsigned long elementCount = mElements.size();
+		if (r.mNodeOffsets.size() != elementCount + 1)
+		{ // the geometry and connectivity of the elements do not change after they are added
+			std::unordered_map<const element::node*, unsigned long> nodeIndices;
+			for (unsigned long i = 0; i < mNodes.size(); ++i) nodeIndices[mNodes[i]] = i;
+			r.mNodeOffsets.assign(1, 0);
+			r.mNodeIndices.clear();
+			r.mVolume.resize(elementCount);
+			r.mTypes.resize(elementCount);
+			r.mCenters.resize(3, elementCount);
+			for (unsigned long i = 0; i < elementCount; ++i)
+			{
+				const auto& ele = mElements[i];
+				for (const auto& j : ele->getNodes()) r.mNodeIndices.push_back(nodeIndices.at(j));
+				r.mNodeOffsets.push_back(r.mNodeIndices.size());
+				r.mVolume(i) = ele->getVolume();
+				r.mCenters.col(i) = ele->getCenter();
+				if (ele->isTruss()) r.mTypes(i) = element_results::TRUSS;
+				else if (ele->isBeam()) r.mTypes(i) = element_results::BEAM;
+				else if (ele->isFlatShell()) r.mTypes(i) = element_results::FLAT_SHELL;
+				else r.mTypes(i) = element_results::QUAD_HEXAHEDRON;
+			}
+		}
+		
+		r.mEnergies.resize(elementCount, mLoadCases.size());
+		r.mTotalEnergy.resize(elementCount);
+		r.mAxialEnergy.setZero(elementCount);
+		r.mShearEnergy.setZero(elementCount);
+		r.mBendEnergy.setZero(elementCount);
+		r.mActiveInCompliance.resize(elementCount);
+		auto updateElement = [&](const unsigned long& i)
+		{
+			const auto& ele = mElements[i];
+			for (unsigned int j = 0; j < mLoadCases.size(); ++j)
+			{
+				try
+				{
+					r.mEnergies(i,j) = ele->getEnergy(mLoadCases[j]);
+				}
+				catch (std::exception& e)
+				{ // the response has not been computed
+					r.mEnergies(i,j) = 0.0;
+				}
+			}
+			r.mTotalEnergy(i) = ele->getTotalEnergy();
+			if (r.mTypes(i) == element_results::FLAT_SHELL)
+			{
+				r.mAxialEnergy(i) = ele->getTotalEnergy("axial");
+				r.mShearEnergy(i) = ele->getTotalEnergy("shear");
+				r.mBendEnergy(i) = ele->getTotalEnergy("bending");
+			}
+			r.mActiveInCompliance(i) = ele->isActiveInCompliance() ? 1.0 : 0.0;
+		};
+		if (mParallel) bso::utilities::parallel_for(0, elementCount, mThreadCount, updateElement);
+		else for (unsigned long i = 0; i < elementCount; ++i) updateElement(i);
+	} // updateElementResults()
+	
+	const element_results& fea::getElementResults()
+	{
+		if (mElementResults.size() != mElements.size()) this->updateElementResults();
+		return mElementResults;
+	} // getElementResults()
+	
 	fea::fea()
 	{
 		
@@ -173,15 +461,14 @@ namespace bso { namespace structural_design {
 	
 	element::node* fea::addNode(const bso::utilities::geometry::vertex& point)
 	{
-		for (auto i : mNodes)
+		unsigned long index;
+		if (mNodeGrid.find(point,index))
 		{
-			if (i->isSameAs(point)) 
-			{
-				return i;
-			}
+			return mNodes[index];
 		}
 		unsigned int nodeID = mNodes.size()+1;
 		mNodes.push_back(new element::node(point,nodeID));
+		mNodeGrid.insert(point);
 		return mNodes.back();
 	} // addNode()
 	
@@ -201,7 +488,7 @@ namespace bso { namespace structural_design {
 			// get all the load cases
 			for (auto& i : mNodes)
 			{
-				auto nodalLC = i->getLoadCases();
+				const auto& nodalLC = i->getLoadCases();
 				for (auto& j : nodalLC)
 				{
 					if (std::find(mLoadCases.begin(), mLoadCases.end(),j) == mLoadCases.end())
@@ -211,38 +498,40 @@ namespace bso { namespace structural_design {
 				}
 			}
 			
-			// create and fill the load vectors
-			for (auto& i : mLoadCases)
+			// create and fill the load matrix, one column per load case
+			mLoadCaseIndices.clear();
+			mLoads.setZero(mDOFCount,mLoadCases.size());
+			for (unsigned int i = 0; i < mLoadCases.size(); ++i)
 			{
-				mLoads[i] = Eigen::VectorXd::Zero(mDOFCount);
+				mLoadCaseIndices[mLoadCases[i]] = i;
 				for (auto & j : mNodes)
 				{
-					Eigen::Vector6d nodalLoads;
-					try
-					{
-						Eigen::Vector6d nodalLoads = j->getLoads(i);
-					}
-					catch (std::exception& e)
-					{
-						// this node does not have a load with this load case
-						j->addLoadCase(i);
-						Eigen::Vector6d nodalLoads = j->getLoads(i);
+					const auto& nodalLC = j->getLoadCases();
+					if (std::find(nodalLC.begin(), nodalLC.end(), mLoadCases[i]) == nodalLC.end())
+					{ // this node does not have a load with this load case
+						j->addLoadCase(mLoadCases[i]);
 					}
+					const Eigen::Vector6d& nodalLoads = j->getLoads(mLoadCases[i]);
+					const auto& NFT = j->getNFT();
 					for (unsigned int k = 0; k < 6; ++k)
 					{
-						if (j->getNFS(k) == 0 || j->getConstraint(k) == 1) continue;
-						unsigned int DOF = j->getGlobalDOF(k);
-						mLoads[i](DOF) = nodalLoads(k);
+						if (NFT[k] >= 0) mLoads(NFT[k],i) = nodalLoads(k);
 					}
 				}
 			}
 			
-			// create the displacement vectors
-			for (auto& i : mLoadCases) mDisplacements[i] = Eigen::VectorXd::Zero(mDOFCount);
+			// create the displacement matrix
+			mDisplacements.setZero(mDOFCount,mLoadCases.size());
 			
 			mSystemInitialized = true;
 		}
 	
+		if (mScatterMapInitialized && mScatterOffsets.size() == mElements.size()+1)
+		{ // the sparsity pattern is known, only scatter the element stiffness matrices
+			this->scatterGSM();
+			return;
+		}
+		
 		mGSM.resize(0,0); // clear it in case there are still any components left
 		mGSM.resize(mDOFCount,mDOFCount); // size it to the numbe rof DOF''s in the system
 		
@@ -254,22 +543,43 @@ namespace bso { namespace structural_design {
 		}
 		
 		mGSM.setFromTriplets(triplets.begin(), triplets.end());
+		this->generateScatterMap();
+		this->updateGSMPattern();
 	} // generateGSM()
 	
 	void fea::clearResponse()
 	{
 		for (auto& i : mElements) i->clearResponse();
 		for (auto& i : mNodes) i->clearDisplacements();
-		for (auto& i : mDisplacements) i.second.setZero();
+		mDisplacements.setZero();
+		mElementResults.mEnergies.setZero();
+		mElementResults.mTotalEnergy.setZero();
+		mElementResults.mAxialEnergy.setZero();
+		mElementResults.mShearEnergy.setZero();
+		mElementResults.mBendEnergy.setZero();
 	} // clearResponse()
 	
+	void fea::setParallel(const bool& parallel /*= true*/, const unsigned int& threadCount /*= 0*/)
+	{
+		mParallel = parallel;
+		if (threadCount == 0) mThreadCount = bso::utilities::default_thread_count();
+		else mThreadCount = threadCount;
+	} // setParallel()
+	
+	void fea::setMeshHierarchy(const std::vector<mesh_transfer>& hierarchy)
+	{
+		mMeshHierarchy = hierarchy;
+		mMGCGPatternCount = 0;
+	} // setMeshHierarchy()
+	
 	void fea::solve(std::string solver /*= "SimplicialLLT"*/)
 	{
 		msolver = solver;
 		// solve the system with the specified solver
 		this->clearResponse();
-		if (solver == "SimplicialLLT") this->simplicialLLT();
-		else if (solver == "SimplicialLDLT") this->simplicialLDLT();
+		if (solver::is_direct_solver(solver)) this->directSolve(solver);
+		else if (solver == "PCG") this->PCG();
+		else if (solver == "MGCG") this->MGCG();
 		else if (solver == "BiCGSTAB") this->BiCGSTAB();
 		else if (solver == "scaledBiCGSTAB") this->scaledBiCGSTAB();
 		else 
@@ -280,9 +590,27 @@ namespace bso { namespace structural_design {
 									 << "(bso/structural_design/fea.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-
+		this->computeResponses();
+	} // solve()
+	
+	void fea::computeResponses()
+	{
+		if (mParallel)
+		{ // each node and element only writes to its own response
+			bso::utilities::parallel_for(0, mNodes.size(), mThreadCount, [&](const unsigned long& i)
+			{
+				mNodes[i]->addDisplacements(mDisplacements,mLoadCases);
+			});
+			bso::utilities::parallel_for(0, mElements.size(), mThreadCount, [&](const unsigned long& i)
+			{
+				for (auto& j : mLoadCases) mElements[i]->computeResponse(j);
+			});
+			this->updateElementResults();
+			return;
+		}
+		
 		// add the displacements to the nodes
-		for (auto& i : mNodes) i->addDisplacements(mDisplacements);
+		for (auto& i : mNodes) i->addDisplacements(mDisplacements,mLoadCases);
 		
 		// compute the responses for elements for every load case
 		for (auto& i : mElements) 
@@ -291,72 +619,206 @@ namespace bso { namespace structural_design {
 			{
 				i->computeResponse(j);
 			}
-		}		
-	} // solve()
+		}
+		this->updateElementResults();
+	} // computeResponses()
 
 	Eigen::MatrixXd fea::solveAdjoint(Eigen::MatrixXd& ae) // for stress_based topopt
 	{
+		auto solverSearch = mDirectSolvers.find(msolver);
+		if (solverSearch == mDirectSolvers.end())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCould not solve Adjoint system with solver type: "
+										<< msolver << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		
 		Eigen::MatrixXd Lambda;
-		if (msolver == "SimplicialLLT")
+		try
 		{
-			try
+			Lambda = solverSearch->second->solve(ae);
+			if (solverSearch->second->info() != Eigen::Success)
 			{
-				Lambda = mLLTSolver.solve(ae);
-				if (mLLTSolver.info() != Eigen::Success)
-				{
-					throw std::runtime_error("Solver failed");
-				}
+				throw std::runtime_error("Solver failed");
 			}
-			catch (std::exception& e)
+		}
+		catch (std::exception& e)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nWhen solving an Adjoint system with " << msolver << " \n"
+									<< "received the following error:\n" << e.what() << "\n"
+									<< "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		return Lambda;
+	} // solveAdjoint()
+
+	Eigen::MatrixXd fea::solveAdjoint(const Eigen::SparseMatrix<double>& ae)
+	{ // the solution is dense, only the right-hand sides are stored sparse
+		Eigen::MatrixXd aeDense = ae;
+		return this->solveAdjoint(aeDense);
+	} // solveAdjoint()
+
+	void fea::solveRealizations(const std::vector<Eigen::VectorXd>& stiffnessFactors,
+		std::vector<Eigen::MatrixXd>& displacements, const std::string& solverName /*= "SimplicialLDLT"*/)
+	{
+		if (!solver::is_direct_solver(solverName))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot solve the realizations of an FEA system with solver:\n"
+									 << solverName << ", it is not a direct solver.\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		for (const auto& i : stiffnessFactors)
+		{
+			if ((unsigned long)i.size() != mElements.size())
 			{
 				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving an Adjoint system with SimplicialLLT \n"
-										<< "received the following error:\n" << e.what() << "\n"
-										<< "(bso/structural_design/fea.cpp)" << std::endl;
-				throw std::runtime_error(errorMessage.str());
+				errorMessage << "\nCannot solve a realization with " << i.size() << " stiffness factors\n"
+										 << "for an FEA system with " << mElements.size() << " elements.\n"
+										 << "(bso/structural_design/fea.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
 			}
 		}
-		else if (msolver == "SimplicialLDLT")
+		if (!mScatterMapInitialized || mScatterOffsets.size() != mElements.size()+1)
+		{ // the pattern and the scatter map follow from the first GSM
+			this->generateGSM();
+		}
+		
+		unsigned long realizationCount = stiffnessFactors.size();
+		if (realizationCount == 1)
+		{ // solved in place, so the realizations do not keep a copy of the GSM
+			mRealizationGSMs.clear();
+			mRealizationSolvers.clear();
+			mRealizationPatternCounts.clear();
+		}
+		else
 		{
-			try
+			if (mRealizationSolverName != solverName) mRealizationSolvers.clear();
+			mRealizationSolverName = solverName;
+			mRealizationGSMs.resize(realizationCount);
+			mRealizationSolvers.resize(realizationCount);
+			mRealizationPatternCounts.resize(realizationCount, 0);
+		}
+		displacements.resize(realizationCount);
+		
+		auto solveRealization = [&](const unsigned long& i)
+		{
+			solver::direct_solver* directSolver;
+			if (realizationCount == 1)
+			{ // the values of mGSM and the cached direct solver of the system
+				this->scatterGSM(stiffnessFactors[i], mGSM.valuePtr());
+				directSolver = &(this->factorizeGSM(solverName));
+			}
+			else
 			{
-				Lambda = mLDLTSolver.solve(ae);
-				if (mLDLTSolver.info() != Eigen::Success)
+				auto& realizationSolver = mRealizationSolvers[i];
+				auto& GSM = mRealizationGSMs[i];
+				if (!realizationSolver)
 				{
-					throw std::runtime_error("Solver failed");
+					realizationSolver.reset(solver::create_direct_solver(solverName));
+					mRealizationPatternCounts[i] = 0;
+				}
+				if (mRealizationPatternCounts[i] != mGSMPatternCount)
+				{ // copy the pattern of the GSM and redo the ordering and symbolic factorization
+					GSM = mGSM;
+					realizationSolver->analyzePattern(GSM);
+					mRealizationPatternCounts[i] = mGSMPatternCount;
 				}
+				this->scatterGSM(stiffnessFactors[i], GSM.valuePtr());
+				realizationSolver->factorize(GSM);
+				directSolver = realizationSolver.get();
 			}
-			catch (std::exception& e)
+			if (directSolver->info() == Eigen::Success) displacements[i] = directSolver->solve(mLoads);
+			if (directSolver->info() != Eigen::Success)
 			{
 				std::stringstream errorMessage;
-				errorMessage << "\nWhen solving an Adjoint system with SimplicialLDLT \n"
-										<< "received the following error:\n" << e.what() << "\n"
-										<< "(bso/structural_design/fea.cpp)" << std::endl;
+				errorMessage << "\nWhen solving realization " << i << " of an FEA system with " << solverName << ",\n"
+										 << "Could not decompose the GSM or solve for the loads\n"
+										 << "(bso/structural_design/fea.cpp)" << std::endl;
 				throw std::runtime_error(errorMessage.str());
 			}
-		}
-		else
+		};
+		bso::utilities::parallel_for(0, realizationCount, mParallel ? mThreadCount : 1, solveRealization);
+	} // solveRealizations()
+
+	void fea::setDisplacements(const Eigen::MatrixXd& displacements)
+	{
+		if (displacements.rows() != mLoads.rows() || displacements.cols() != mLoads.cols())
 		{
 			std::stringstream errorMessage;
-			errorMessage << "\nCould not solve Adjoint system with solver type: "
-										<< msolver << std::endl;
-			throw std::runtime_error(errorMessage.str());
+			errorMessage << "\nCannot set displacements of size " << displacements.rows() << "x"
+									 << displacements.cols() << " for an FEA system with loads of size "
+									 << mLoads.rows() << "x" << mLoads.cols() << ".\n"
+									 << "(bso/structural_design/fea.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
 		}
-		return Lambda;
-	} // solveAdjoint()
+		this->clearResponse();
+		mDisplacements = displacements;
+		this->computeResponses();
+	} // setDisplacements()
 
+	double fea::estimateConditionNumber()
+	{ // the GSM is symmetric, so its singular values are the magnitudes of its eigenvalues
+		if (mGSM.nonZeros() == 0) return std::numeric_limits<double>::infinity();
+		
+		// a failed factorization means a zero pivot, i.e. the GSM is singular
+		auto& LDLT = this->factorizeGSM("SimplicialLDLT");
+		if (LDLT.info() != Eigen::Success) return std::numeric_limits<double>::infinity();
+		
+		const unsigned int maxIterations = 300;
+		const double tolerance = 1e-6;
+		std::mt19937 randomGenerator(0);
+		std::uniform_real_distribution<double> distribution(0.5,1.5);
+		Eigen::VectorXd startVector(mDOFCount);
+		for (unsigned long i = 0; i < mDOFCount; ++i) startVector(i) = distribution(randomGenerator);
+		startVector.normalize();
+		
+		// largest eigenvalue magnitude by power iteration
+		Eigen::VectorXd v = startVector, w;
+		double lambdaMax = 0.0;
+		for (unsigned int i = 0; i < maxIterations; ++i)
+		{
+			w = mGSM * v;
+			double lambda = w.norm();
+			if (lambda == 0) return std::numeric_limits<double>::infinity();
+			v = w / lambda;
+			bool converged = std::abs(lambda - lambdaMax) <= tolerance * lambda;
+			lambdaMax = lambda;
+			if (converged) break;
+		}
+		
+		// smallest eigenvalue magnitude by inverse iteration on the factorization
+		v = startVector;
+		double lambdaMinInverse = 0.0;
+		for (unsigned int i = 0; i < maxIterations; ++i)
+		{
+			w = LDLT.solve(v);
+			double lambdaInverse = w.norm();
+			if (!std::isfinite(lambdaInverse) || lambdaInverse == 0)
+			{
+				return std::numeric_limits<double>::infinity();
+			}
+			v = w / lambdaInverse;
+			bool converged = std::abs(lambdaInverse - lambdaMinInverse) <= tolerance * lambdaInverse;
+			lambdaMinInverse = lambdaInverse;
+			if (converged) break;
+		}
+		
+		return lambdaMax * lambdaMinInverse;
+	} // estimateConditionNumber()
+	
 	bool fea::isSingular()
 	{
-		if (mGSM.nonZeros() == 0) return true;
-		Eigen::JacobiSVD<Eigen::MatrixXd> SVD(mGSM);
-		double cond = SVD.singularValues()(0) / SVD.singularValues()(SVD.singularValues().size()-1);
-		return cond > 1e10;
-	}
+		return this->estimateConditionNumber() > 1e10;
+	} // isSingular()
 
 	Eigen::VectorXd fea::getDisplacements(element::load_case lc) const
 	{
-		auto dispSearch = mDisplacements.find(lc);
-		if (dispSearch == mDisplacements.end())
+		auto indexSearch = mLoadCaseIndices.find(lc);
+		if (indexSearch == mLoadCaseIndices.end())
 		{
 			std::stringstream errorMessage;
 			errorMessage << "\nRequested displacements for unknown load case:\n"
@@ -364,7 +826,7 @@ namespace bso { namespace structural_design {
 									 << "(bso/structural_design/fea.cpp)" << std::endl;
 			throw std::invalid_argument(errorMessage.str());
 		}
-		return dispSearch->second;
+		return mDisplacements.col(indexSearch->second);
 	}
 	
 } // namespace structural_design
@@ -2,32 +2,127 @@
 #define SD_FEA_HPP
 
 #include <bso/structural_design/element/elements.hpp>
+#include <bso/structural_design/solver/direct_solver.hpp>
+#include <bso/structural_design/solver/multigrid.hpp>
+#include <bso/utilities/vertex_hash_grid.hpp>
+#include <bso/utilities/parallel_for.hpp>
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
 
+#include <memory>
+
 namespace bso { namespace structural_design {
 	
+	struct element_results
+	{ // structure-of-arrays view of the element results, indexed as fea::getElements()
+		enum element_type {TRUSS, BEAM, FLAT_SHELL, QUAD_HEXAHEDRON};
+		
+		Eigen::MatrixXd mEnergies; // elements x load cases, columns as fea::getLoadCases()
+		Eigen::VectorXd mTotalEnergy; // summed over the load cases
+		Eigen::VectorXd mAxialEnergy; // the axial, shear and bending energies are zero
+		Eigen::VectorXd mShearEnergy; // for elements other than flat shells
+		Eigen::VectorXd mBendEnergy;
+		Eigen::VectorXd mVolume;
+		Eigen::VectorXd mActiveInCompliance; // 1.0 if the element is active in compliance, 0.0 if not
+		Eigen::VectorXi mTypes; // element_type of each element
+		Eigen::Matrix3Xd mCenters;
+		
+		// the indices in fea::getNodes() of the nodes of element i are in
+		// mNodeIndices[mNodeOffsets[i]] up to mNodeIndices[mNodeOffsets[i+1]]
+		std::vector<unsigned long> mNodeOffsets;
+		std::vector<unsigned long> mNodeIndices;
+		
+		unsigned long size() const {return mVolume.size();}
+		Eigen::VectorXd typeMask(const element_type& type) const; // 1.0 for elements of this type, 0.0 otherwise
+	};
+	
+	struct mesh_transfer
+	{ // interpolation of the nodes of a coarser mesh to the nodes of the next finer mesh
+		std::vector<unsigned long> mCoarseNodes; // index in fea::getNodes() of each coarse node
+		// fine nodes x coarse nodes, the fine nodes are fea::getNodes() for the
+		// finest mesh, else the coarse nodes of the previous transfer
+		Eigen::SparseMatrix<double> mProlongation;
+	};
+	
 	class fea
 	{
 	private:
 		std::vector<element::node*> mNodes;
+		bso::utilities::vertex_hash_grid mNodeGrid; // spatial index of mNodes
 		std::vector<element::element*> mElements;
 		
 		unsigned long mDOFCount = 0;
 		std::vector<element::load_case> mLoadCases;
-		std::map<element::load_case,Eigen::VectorXd> mLoads;
-		std::map<element::load_case,Eigen::VectorXd> mDisplacements;
+		std::map<element::load_case,unsigned int> mLoadCaseIndices; // column of each load case in mLoads and mDisplacements
+		Eigen::MatrixXd mLoads; // DOFs x load cases
+		Eigen::MatrixXd mDisplacements; // DOFs x load cases
 		
 		Eigen::SparseMatrix<double> mGSM;
 		bool mSystemInitialized = false;
 		
+		// sparsity pattern of mGSM, the symbolic factorization of the direct
+		// solvers is only redone when the pattern changes
+		std::vector<Eigen::SparseMatrix<double>::StorageIndex> mGSMOuterIndices;
+		std::vector<Eigen::SparseMatrix<double>::StorageIndex> mGSMInnerIndices;
+		unsigned long mGSMPatternCount = 0; // increases each time the pattern of mGSM changes
+		
+		bool mParallel = false; // compute the responses in parallel
+		unsigned int mThreadCount = 1;
+		
 		std::string msolver;
-		Eigen::SimplicialLLT<Eigen::SparseMatrix<double> > mLLTSolver;
-		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > mLDLTSolver;
+		std::map<std::string, std::unique_ptr<solver::direct_solver> > mDirectSolvers; // by solver name
+		std::map<std::string, unsigned long> mDirectSolverPatternCounts; // pattern that each direct solver analyzed
+		
+		void updateGSMPattern();
+		
+		// scatter map of the element stiffness matrices into the values of mGSM,
+		// for element i the entries in [mScatterOffsets[i], mScatterOffsets[i+1])
+		std::vector<unsigned long> mScatterOffsets;
+		std::vector<unsigned long> mScatterLocalIndices; // index in the element's stiffness matrix data
+		std::vector<unsigned long> mScatterGlobalIndices; // index in mGSM.valuePtr()
+		bool mScatterMapInitialized = false;
+		
+		void generateScatterMap();
+		void scatterGSM();
+		void scatterGSM(const Eigen::VectorXd& stiffnessFactors, double* values) const; // stiffness factors indexed as mElements
+		
+		// realizations of the GSM for other stiffness factors of the elements, each
+		// with its own values on the pattern of mGSM and its own direct solver (only
+		// when there are several, a single realization is solved in place)
+		std::vector<Eigen::SparseMatrix<double> > mRealizationGSMs;
+		std::vector<std::unique_ptr<solver::direct_solver> > mRealizationSolvers;
+		std::vector<unsigned long> mRealizationPatternCounts; // pattern that each realization solver analyzed
+		std::string mRealizationSolverName;
+		
+		element_results mElementResults;
+		void updateElementResults(); // refreshes mElementResults after a solve
+		void computeResponses(); // of the nodes and elements, from mDisplacements
 
+		// preconditioned conjugate gradient solver, warm started from the
+		// displacements of the previous PCG solve
+		Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper,
+			Eigen::IncompleteCholesky<double> > mPCGSolver;
+		unsigned long mPCGPatternCount = 0; // pattern that mPCGSolver analyzed
+		Eigen::MatrixXd mPCGGuess;
+		double mPCGTolerance = 1e-8;
+		unsigned long mPCGIterations = 0; // summed over the load cases of the last PCG or MGCG solve
+		
+		// conjugate gradient solver preconditioned with geometric multigrid on the
+		// mesh hierarchy, warm started from the displacements of the previous MGCG solve
+		std::vector<mesh_transfer> mMeshHierarchy; // from the finest to the coarsest mesh
+		Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper,
+			solver::multigrid_preconditioner> mMGCGSolver;
+		unsigned long mMGCGPatternCount = 0; // pattern that mMGCGSolver analyzed
+		Eigen::MatrixXd mMGCGGuess;
+		std::vector<Eigen::SparseMatrix<double> > generateProlongations() const; // DOF prolongations of mMeshHierarchy
+		template <class ITERATIVE_SOLVER>
+		void iterativeSolve(ITERATIVE_SOLVER& solver, Eigen::MatrixXd& guess, const std::string& solverName);
+		
 		// solvers
-		void simplicialLLT();
-		void simplicialLDLT();
+		solver::direct_solver& factorizeGSM(const std::string& solverName);
+		void directSolve(const std::string& solverName);
+		void PCG();
+		void MGCG();
 		void BiCGSTAB();
 		void scaledBiCGSTAB();
 	public:
@@ -40,16 +135,40 @@ namespace bso { namespace structural_design {
 		void generateGSM();
 		void clearResponse();
 		
+		void setParallel(const bool& parallel = true, const unsigned int& threadCount = 0); // threadCount = 0: number of hardware threads
 		void solve(std::string solver = "SimplicialLDLT");
 		Eigen::MatrixXd solveAdjoint(Eigen::MatrixXd& ae);
+		Eigen::MatrixXd solveAdjoint(const Eigen::SparseMatrix<double>& ae); // one column per adjoint load
+		// solves the displacements of several realizations of the element stiffness
+		// factors (e.g. the designs of robust topology optimization), concurrently if
+		// the system is parallel. Only the displacements are computed, the elements
+		// and nodes keep their response. Requires a direct solver. A single realization
+		// is solved in place: the GSM then holds its values, until the next generateGSM().
+		void solveRealizations(const std::vector<Eigen::VectorXd>& stiffnessFactors,
+			std::vector<Eigen::MatrixXd>& displacements, const std::string& solverName = "SimplicialLDLT");
+		// replaces the displacements (e.g. by those of a realization), the responses of the
+		// nodes and elements follow from them and the current element densities
+		void setDisplacements(const Eigen::MatrixXd& displacements);
+		double estimateConditionNumber(); // estimate of the 2-norm condition number of the GSM
 		bool isSingular();
 		
 		Eigen::VectorXd getDisplacements(element::load_case lc) const;
+		const Eigen::MatrixXd& getLoads() const {return mLoads;}
+		const Eigen::MatrixXd& getDisplacements() const {return mDisplacements;}
+		const std::vector<element::load_case>& getLoadCases() const {return mLoadCases;}
 		const std::vector<element::node*>& getNodes() const {return mNodes;}
 		std::vector<element::node*>& getNodes() {return mNodes;}
 		const std::vector<element::element*>& getElements() const {return mElements;}
 		std::vector<element::element*>& getElements() {return mElements;}
 		const unsigned long& getDOFCount() const {return mDOFCount;}
+		const Eigen::SparseMatrix<double>& getGSM() const {return mGSM;}
+		void setPCGTolerance(const double& tol) {mPCGTolerance = tol;} // also of MGCG
+		void setMeshHierarchy(const std::vector<mesh_transfer>& hierarchy); // required by MGCG
+		const std::vector<mesh_transfer>& getMeshHierarchy() const {return mMeshHierarchy;}
+		const unsigned long& getPCGIterations() const {return mPCGIterations;}
+		const bool& isParallel() const {return mParallel;}
+		const unsigned int& getThreadCount() const {return mThreadCount;}
+		const element_results& getElementResults(); // refreshed after each solve
 	};
 	
 } // namespace structural_design
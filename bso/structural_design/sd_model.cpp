@@ -3,6 +3,8 @@
 
 #include <bso/structural_design/topology_optimization/topology_optimization.hpp>
 
+#include <unordered_map>
+
 namespace bso { namespace structural_design {
 	
 	void sd_model::clearMesh()
@@ -15,6 +17,7 @@ namespace bso { namespace structural_design {
 			delete mFEA;
 			mFEA = new fea();
 			mMeshedPoints.clear();
+			mElementTree.clear();
 		}
 	} // clearMesh()
 
@@ -62,7 +65,12 @@ namespace bso { namespace structural_design {
 			for (const auto& j : i->getConstraints()) newSDGeom->addConstraint(j);
 		}
 		mMeshSize = rhs.mMeshSize;
+		mMultigridLevels = rhs.mMultigridLevels;
+		mParallelFEA = rhs.mParallelFEA;
+		mFEAThreadCount = rhs.mFEAThreadCount;
 		mTopOptStreamBuffer = rhs.mTopOptStreamBuffer;
+		mTopOptSolver = rhs.mTopOptSolver;
+		mRobustMinMax = rhs.mRobustMinMax;
 	}
 
 	sd_model::~sd_model()
@@ -75,15 +83,14 @@ namespace bso { namespace structural_design {
 
 	component::point* sd_model::addPoint(bso::utilities::geometry::vertex p)
 	{
-		for (auto& i : mPoints)
+		unsigned long index;
+		if (mPointGrid.find(p,index))
 		{
-			if (i->isSameAs(p))
-			{
-				return i;
-			}
+			return mPoints[index];
 		}
 		unsigned int pointID = mPoints.size();
 		mPoints.push_back(new component::point(pointID, p));
+		mPointGrid.insert(p);
 		return mPoints.back();
 	} // addPoint()
 
@@ -154,9 +161,7 @@ namespace bso { namespace structural_design {
 		// mesh the points
 		for (auto& i : mPoints)
 		{
-			unsigned long pointID = mMeshedPoints.size();
-			mMeshedPoints.push_back(new component::point(pointID, *i));
-			auto meshedPoint = mMeshedPoints.back();
+			auto meshedPoint = mMeshedPoints.addPoint(*i);
 			for (const auto& j : i->getLoads())
 			{
 				meshedPoint->addLoad(j);
@@ -177,6 +182,7 @@ namespace bso { namespace structural_design {
 		std::map<component::point*, element::node*> nodeMap;
 		element::node* nodePtr;
 		mFEA = new fea();
+		mFEA->setParallel(mParallelFEA,mFEAThreadCount);
 		for (auto& i : mMeshedPoints)
 		{
 			nodePtr = mFEA->addNode(*i);
@@ -198,6 +204,7 @@ namespace bso { namespace structural_design {
 		// create the elements
 		unsigned long elementID = 0;
 		element::element* elePtr;
+		element::stiffness_cache stiffnessCache; // congruent elements share their stiffness terms
 		for (auto& i : mGeometries)
 		{
 			if (i->hasTruss())
@@ -229,7 +236,7 @@ namespace bso { namespace structural_design {
 
 						elePtr = new element::truss(elementID++,j.E(), j.A(),
 													{firstNodeSearch->second,secondNodeSearch->second},
-													ERelativeLowerBound);
+													ERelativeLowerBound, &stiffnessCache);
 						mFEA->addElement(elePtr);
 						i->addElement(elePtr);
 						if (j.isGhostComponent()) elePtr->isActiveInCompliance() = false;
@@ -265,20 +272,20 @@ namespace bso { namespace structural_design {
 					{
 						elePtr = new element::beam(elementID++,
 													k.E(), k.width(), k.height(), 
-													k.poisson(), elementNodes, ERelativeLowerBound);
+													k.poisson(), elementNodes, ERelativeLowerBound, &stiffnessCache);
 						mFEA->addElement(elePtr);
 					}
 					else if (k.type() == "flat_shell")
 					{
 						elePtr = new element::flat_shell(elementID++,
 													k.E(), k.thickness(), k.poisson(), 
-													elementNodes, ERelativeLowerBound);
+													elementNodes, ERelativeLowerBound, 1e-3, &stiffnessCache);
 						mFEA->addElement(elePtr);
 					}
 					else if (k.type() == "quad_hexahedron")
 					{
 						elePtr = new element::quad_hexahedron(elementID++,
-													k.E(), k.poisson(), elementNodes, ERelativeLowerBound);
+													k.E(), k.poisson(), elementNodes, ERelativeLowerBound, 1e-3, &stiffnessCache);
 						mFEA->addElement(elePtr);
 					}
 					else
@@ -297,11 +304,164 @@ namespace bso { namespace structural_design {
 			}
 		}
 
+		if (mMultigridLevels > 1) this->generateMeshHierarchy(nodeMap);
+
 		// generate the fea system
 		mFEA->generateGSM();
 		mIsMeshed = true;
 	} // mesh()
 
+	void sd_model::setMultigridLevels(const unsigned int& levels /*= 3*/)
+	{
+		if (levels == 0)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nError, cannot set the number of multigrid levels to zero,\n"
+									 << "(bso/structural_design/sd_model.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		mMultigridLevels = levels;
+	} // setMultigridLevels()
+
+	void sd_model::generateMeshHierarchy(const std::map<component::point*, element::node*>& nodeMap)
+	{ // the meshes of the geometries are structured grids, the grid of mesh size n/2 consists of
+		// the points with even indices of the grid of mesh size n
+		const auto& nodes = mFEA->getNodes();
+		std::unordered_map<const element::node*, unsigned long> nodeIndices;
+		for (unsigned long i = 0; i < nodes.size(); ++i) nodeIndices[nodes[i]] = i;
+
+		struct grid
+		{
+			std::vector<unsigned int> mSize; // number of intervals in each direction
+			std::vector<unsigned long> mNodes; // index in nodes of each grid point
+		};
+		std::vector<grid> grids;
+		for (const auto& i : mGeometries)
+		{
+			if (i->getMeshGrid().empty()) continue;
+			grid g;
+			g.mSize = i->getMeshGrid();
+			for (const auto& j : i->getMeshedPoints()) g.mNodes.push_back(nodeIndices.at(nodeMap.at(j)));
+			grids.push_back(std::move(g));
+		}
+
+		std::vector<mesh_transfer> hierarchy;
+		std::vector<unsigned long> fineNodes(nodes.size());
+		for (unsigned long i = 0; i < nodes.size(); ++i) fineNodes[i] = i;
+		for (unsigned int level = 1; level < mMultigridLevels; ++level)
+		{
+			bool nested = true;
+			for (const auto& g : grids)
+			{
+				for (const auto& n : g.mSize) if (n%2 != 0) nested = false;
+			}
+			if (!nested) break; // the mesh size cannot be halved again
+
+			// a node is a coarse node if it has even indices in a grid, or if it is in none
+			std::vector<long> finePositions(nodes.size(), -1), coarsePositions(nodes.size(), -1);
+			for (unsigned long i = 0; i < fineNodes.size(); ++i) finePositions[fineNodes[i]] = i;
+			std::vector<bool> isCoarse(nodes.size(), false), inGrid(nodes.size(), false);
+			auto gridIndices = [](const grid& g, unsigned long p)
+			{
+				std::vector<unsigned int> indices;
+				for (const auto& n : g.mSize)
+				{
+					indices.push_back(p%(n+1));
+					p /= (n+1);
+				}
+				return indices;
+			};
+			for (const auto& g : grids)
+			{
+				for (unsigned long p = 0; p < g.mNodes.size(); ++p)
+				{
+					inGrid[g.mNodes[p]] = true;
+					bool even = true;
+					for (const auto& i : gridIndices(g,p)) if (i%2 != 0) even = false;
+					if (even) isCoarse[g.mNodes[p]] = true;
+				}
+			}
+			mesh_transfer transfer;
+			for (const auto& i : fineNodes)
+			{
+				if (!inGrid[i]) isCoarse[i] = true;
+				if (!isCoarse[i]) continue;
+				coarsePositions[i] = transfer.mCoarseNodes.size();
+				transfer.mCoarseNodes.push_back(i);
+			}
+
+			// coarse nodes are injected, the others are interpolated (multi)linearly
+			// in the first grid that contains them
+			std::vector<Eigen::Triplet<double> > triplets;
+			std::vector<bool> interpolated(nodes.size(), false);
+			for (const auto& i : transfer.mCoarseNodes)
+			{
+				triplets.push_back(Eigen::Triplet<double>(finePositions[i], coarsePositions[i], 1.0));
+				interpolated[i] = true;
+			}
+			for (const auto& g : grids)
+			{
+				for (unsigned long p = 0; p < g.mNodes.size(); ++p)
+				{
+					unsigned long fineNode = g.mNodes[p];
+					if (interpolated[fineNode]) continue;
+					interpolated[fineNode] = true;
+
+					// the neighbouring grid points with even indices and their weights
+					std::vector<std::pair<unsigned long, double> > weights = {{0, 1.0}};
+					std::vector<unsigned int> indices = gridIndices(g,p);
+					unsigned long stride = 1;
+					for (unsigned int d = 0; d < indices.size(); ++d)
+					{
+						std::vector<std::pair<unsigned long, double> > newWeights;
+						for (const auto& w : weights)
+						{
+							if (indices[d]%2 == 0) newWeights.push_back({w.first + indices[d]*stride, w.second});
+							else
+							{
+								newWeights.push_back({w.first + (indices[d]-1)*stride, 0.5*w.second});
+								newWeights.push_back({w.first + (indices[d]+1)*stride, 0.5*w.second});
+							}
+						}
+						weights = std::move(newWeights);
+						stride *= g.mSize[d] + 1;
+					}
+					for (const auto& w : weights)
+					{
+						triplets.push_back(Eigen::Triplet<double>(finePositions[fineNode],
+							coarsePositions[g.mNodes[w.first]], w.second));
+					}
+				}
+			}
+			transfer.mProlongation.resize(fineNodes.size(), transfer.mCoarseNodes.size());
+			transfer.mProlongation.setFromTriplets(triplets.begin(), triplets.end());
+
+			// the grids of the coarse mesh
+			for (auto& g : grids)
+			{
+				grid coarseGrid;
+				for (const auto& n : g.mSize) coarseGrid.mSize.push_back(n/2);
+				for (unsigned long p = 0; p < g.mNodes.size(); ++p)
+				{
+					bool even = true;
+					for (const auto& i : gridIndices(g,p)) if (i%2 != 0) even = false;
+					if (even) coarseGrid.mNodes.push_back(g.mNodes[p]);
+				}
+				g = std::move(coarseGrid);
+			}
+			fineNodes = transfer.mCoarseNodes;
+			hierarchy.push_back(std::move(transfer));
+		}
+		mFEA->setMeshHierarchy(hierarchy);
+	} // generateMeshHierarchy()
+
+	void sd_model::setParallelFEA(const bool& parallel /*= true*/, const unsigned int& threadCount /*= 0*/)
+	{
+		mParallelFEA = parallel;
+		mFEAThreadCount = threadCount;
+		if (mIsMeshed) mFEA->setParallel(mParallelFEA,mFEAThreadCount);
+	} // setParallelFEA()
+
 	void sd_model::analyze(std::string solver /*= : SimplicialLLT*/)
 	{
 		if (!mIsMeshed)
@@ -374,99 +534,133 @@ namespace bso { namespace structural_design {
 		mTopOptStreamBuffer = out.rdbuf();
 	}
 	
-	sd_results sd_model::getTotalResults()
+	void sd_model::updateElementTree()
 	{
-		sd_results results;
-		for (const auto& i : mFEA->getElements())
+		const auto& elementResults = mFEA->getElementResults();
+		if (mElementTree.size() == elementResults.size()) return;
+		
+		const auto& nodes = mFEA->getNodes();
+		Eigen::Matrix3Xd minCorners(3,elementResults.size()), maxCorners(3,elementResults.size());
+		for (unsigned long i = 0; i < elementResults.size(); ++i)
 		{
-			if (i->isActiveInCompliance())
-			{
-				results.mTotalStrainEnergy += i->getTotalEnergy();
-				if (i->isFlatShell())
-				{
-					results.mShearStrainEnergy += i->getTotalEnergy("shear");
-					results.mAxialStrainEnergy += i->getTotalEnergy("axial");
-					results.mBendStrainEnergy  += i->getTotalEnergy("bending");
-				}
-				results.mTotalStructuralVolume += i->getVolume();
-			}
-			else
+			Eigen::Vector3d min, max;
+			min.setConstant( std::numeric_limits<double>::infinity());
+			max.setConstant(-std::numeric_limits<double>::infinity());
+			for (unsigned long j = elementResults.mNodeOffsets[i]; j < elementResults.mNodeOffsets[i+1]; ++j)
 			{
-				results.mGhostStrainEnergy += i->getTotalEnergy();
-				results.mGhostStructuralVolume += i->getVolume();
+				min = min.cwiseMin(*nodes[elementResults.mNodeIndices[j]]);
+				max = max.cwiseMax(*nodes[elementResults.mNodeIndices[j]]);
 			}
+			minCorners.col(i) = min;
+			maxCorners.col(i) = max;
 		}
-		return results;
-	} // getTotalResults()
+		mElementTree.build(minCorners,maxCorners);
+	} // updateElementTree()
 	
-	sd_results sd_model::getPartialResults(bso::utilities::geometry::polygon* geom)
-	{
-		sd_results results;
+	template <class GEOMETRY>
+	Eigen::VectorXd sd_model::elementsInsideOrOn(GEOMETRY* geom) const
+	{ // expects an up to date element tree
+		const auto& elementResults = mFEA->getElementResults();
+		const auto& nodes = mFEA->getNodes();
+		Eigen::VectorXd elementMask = Eigen::VectorXd::Zero(elementResults.size());
+		
+		// an element can only be inside or on geom if its box lies in the box of
+		// geom. The tolerance of isInsideOrOn() is not a distance, so the box of
+		// geom is enlarged generously, the exact check decides for the candidates.
+		Eigen::Vector3d min, max;
+		bso::utilities::bounding_box(*geom,min,max);
+		double margin = 1e-3 + 1e-2*(max-min).norm();
+		std::vector<unsigned long> candidates;
+		mElementTree.findContainedIn(min.array()-margin,max.array()+margin,candidates);
 		
-		for (const auto& i : mFEA->getElements())
+		std::unordered_map<unsigned long,bool> nodeInside; // only the nodes of the candidates are checked
+		for (const auto& i : candidates)
 		{
-			bool allPointsInsideOrOn = true;
-			for (const auto& j : i->getNodes())
+			elementMask(i) = 1.0;
+			for (unsigned long j = elementResults.mNodeOffsets[i]; j < elementResults.mNodeOffsets[i+1]; ++j)
 			{
-				auto vertexPtr = dynamic_cast<bso::utilities::geometry::vertex*>(j);
-				if (!geom->isInsideOrOn(*vertexPtr))
+				auto nodeSearch = nodeInside.find(elementResults.mNodeIndices[j]);
+				if (nodeSearch == nodeInside.end())
 				{
-					allPointsInsideOrOn = false;
-					break;
+					nodeSearch = nodeInside.emplace(elementResults.mNodeIndices[j],
+						geom->isInsideOrOn(*nodes[elementResults.mNodeIndices[j]])).first;
 				}
-			}
-			if (!allPointsInsideOrOn) continue;
-			
-			if (i->isActiveInCompliance())
-			{
-				results.mTotalStrainEnergy += i->getTotalEnergy();
-				if (i->isFlatShell())
+				if (!nodeSearch->second)
 				{
-					results.mShearStrainEnergy += i->getTotalEnergy("shear");
-					results.mAxialStrainEnergy += i->getTotalEnergy("axial");
-					results.mBendStrainEnergy  += i->getTotalEnergy("bending");
+					elementMask(i) = 0.0;
+					break;
 				}
-				results.mTotalStructuralVolume += i->getVolume();
-			}
-			else
-			{
-				results.mGhostStrainEnergy += i->getTotalEnergy();
-				results.mGhostStructuralVolume += i->getVolume();
 			}
 		}
+		return elementMask;
+	} // elementsInsideOrOn()
+	
+	sd_results sd_model::sumResults(const Eigen::VectorXd& elementMask, const bool& separateFlatShellEnergies /*= true*/) const
+	{
+		const auto& elementResults = mFEA->getElementResults();
+		Eigen::VectorXd active = elementMask.cwiseProduct(elementResults.mActiveInCompliance);
+		Eigen::VectorXd ghost = elementMask - active;
+		
+		sd_results results;
+		results.mTotalStrainEnergy = active.dot(elementResults.mTotalEnergy);
+		if (separateFlatShellEnergies)
+		{
+			results.mShearStrainEnergy = active.dot(elementResults.mShearEnergy);
+			results.mAxialStrainEnergy = active.dot(elementResults.mAxialEnergy);
+			results.mBendStrainEnergy  = active.dot(elementResults.mBendEnergy);
+		}
+		results.mTotalStructuralVolume = active.dot(elementResults.mVolume);
+		results.mGhostStrainEnergy = ghost.dot(elementResults.mTotalEnergy);
+		results.mGhostStructuralVolume = ghost.dot(elementResults.mVolume);
 		return results;
+	} // sumResults()
+	
+	sd_results sd_model::getTotalResults()
+	{
+		return this->sumResults(Eigen::VectorXd::Ones(mFEA->getElements().size()));
+	} // getTotalResults()
+	
+	sd_results sd_model::getPartialResults(bso::utilities::geometry::polygon* geom)
+	{
+		this->updateElementTree();
+		return this->sumResults(this->elementsInsideOrOn(geom));
 	} // getPartialResults()
 	
 	sd_results sd_model::getPartialResults(bso::utilities::geometry::polyhedron* geom)
 	{
-		sd_results results;
-		
-		for (const auto& i : mFEA->getElements())
+		this->updateElementTree();
+		return this->sumResults(this->elementsInsideOrOn(geom), false);
+	} // getPartialResults()
+	
+	template <class GEOMETRY>
+	std::vector<sd_results> sd_model::sumPartialResults(const std::vector<GEOMETRY*>& geoms,
+		const bool& separateFlatShellEnergies)
+	{ // same as calling getPartialResults() for each geometry
+		this->updateElementTree();
+		std::vector<sd_results> results(geoms.size());
+		unsigned int threadCount = 1;
+		if (mParallelFEA)
 		{
-			bool allPointsInsideOrOn = true;
-			for (const auto& j : i->getNodes())
-			{
-				auto vertexPtr = dynamic_cast<bso::utilities::geometry::vertex*>(j);
-				if (!geom->isInsideOrOn(*vertexPtr))
-				{
-					allPointsInsideOrOn = false;
-					break;
-				}
-			}
-			if (!allPointsInsideOrOn) continue;
-
-			if (i->isActiveInCompliance())
-			{
-				results.mTotalStrainEnergy += i->getTotalEnergy();
-				results.mTotalStructuralVolume += i->getVolume();
-			}
-			else
-			{
-				results.mGhostStrainEnergy += i->getTotalEnergy();
-				results.mGhostStructuralVolume += i->getVolume();
-			}
+			threadCount = (mFEAThreadCount == 0) ? bso::utilities::default_thread_count() : mFEAThreadCount;
 		}
+		bso::utilities::parallel_for(0, geoms.size(), threadCount,
+			[&](const unsigned long& i)
+			{
+				results[i] = this->sumResults(this->elementsInsideOrOn(geoms[i]), separateFlatShellEnergies);
+			});
 		return results;
+	} // sumPartialResults()
+	
+	std::vector<sd_results> sd_model::getPartialResults(
+		const std::vector<bso::utilities::geometry::polygon*>& geoms)
+	{
+		return this->sumPartialResults(geoms, true);
+	} // getPartialResults()
+	
+	std::vector<sd_results> sd_model::getPartialResults(
+		const std::vector<bso::utilities::geometry::polyhedron*>& geoms)
+	{
+		return this->sumPartialResults(geoms, false);
 	} // getPartialResults()
 	
 
@@ -4,7 +4,10 @@
 #include <ostream>
 #include <sstream>
 #include <bso/structural_design/fea.hpp>
+#include <bso/utilities/vertex_hash_grid.hpp>
+#include <bso/utilities/aabb_tree.hpp>
 #include <bso/structural_design/component/point.hpp>
+#include <bso/structural_design/component/point_store.hpp>
 #include <bso/structural_design/component/line_segment.hpp>
 #include <bso/structural_design/component/quadrilateral.hpp>
 #include <bso/structural_design/component/quad_hexahedron.hpp>
@@ -17,15 +20,31 @@ namespace bso { namespace structural_design {
 	{
 	private:
 		std::vector<component::point*> mPoints;
+		bso::utilities::vertex_hash_grid mPointGrid; // spatial index of mPoints
 		std::vector<component::geometry*> mGeometries;
-		std::vector<component::point*> mMeshedPoints;
+		component::point_store mMeshedPoints;
 		
 		fea* mFEA;
 		std::streambuf* mTopOptStreamBuffer;
 		
 		unsigned int mMeshSize = 1;
+		unsigned int mMultigridLevels = 1; // number of meshes in the mesh hierarchy of the FEA system
 		bool mIsMeshed = false;
+		bool mParallelFEA = false;
+		unsigned int mFEAThreadCount = 0;
+		bso::utilities::aabb_tree mElementTree; // spatial index of the elements in mFEA, built on the first region query
+		std::string mTopOptSolver = "SimplicialLDLT";
+		bool mRobustMinMax = false; // ROBUST minimizes the worst of the eroded, nominal and dilated compliance
 		void clearMesh();
+		void generateMeshHierarchy(const std::map<component::point*, element::node*>& nodeMap);
+		void updateElementTree();
+		
+		template <class GEOMETRY>
+		Eigen::VectorXd elementsInsideOrOn(GEOMETRY* geom) const; // 1.0 for elements of which all nodes are inside or on geom, 0.0 otherwise
+		sd_results sumResults(const Eigen::VectorXd& elementMask, const bool& separateFlatShellEnergies = true) const;
+		template <class GEOMETRY>
+		std::vector<sd_results> sumPartialResults(const std::vector<GEOMETRY*>& geoms,
+			const bool& separateFlatShellEnergies); // in parallel over geoms if the FEA is parallel
 	public:
 		sd_model();
 		sd_model(const sd_model& rhs);
@@ -39,6 +58,8 @@ namespace bso { namespace structural_design {
 		void setMeshSize(const unsigned int& n);
 		void mesh();
 		void mesh(const unsigned int& n, bool meshLoadPanels = true);
+		void setMultigridLevels(const unsigned int& levels = 3); // from the next mesh(n): n, n/2, n/4, ... for the "MGCG" solver
+		void setParallelFEA(const bool& parallel = true, const unsigned int& threadCount = 0); // applies to the FEA system of each mesh
 		void analyze(std::string solver = "SimplicialLDLT");
 		bool isStable();
 		
@@ -48,10 +69,14 @@ namespace bso { namespace structural_design {
 		template <typename T, typename...ARGS>
 		void topologyOptimization(const ARGS&...);
 		void setTopOptOutputStream(std::ostream& out);
+		void setTopOptSolver(const std::string& solver) {mTopOptSolver = solver;} // solver of the FEA system in each iteration
+		void setRobustMinMax(const bool& minMax = true) {mRobustMinMax = minMax;} // see robust.cpp, three FEA solves per iteration instead of one
 		
 		sd_results getTotalResults();
 		sd_results getPartialResults(bso::utilities::geometry::polygon* geom);
 		sd_results getPartialResults(bso::utilities::geometry::polyhedron* geom);
+		std::vector<sd_results> getPartialResults(const std::vector<bso::utilities::geometry::polygon*>& geoms);
+		std::vector<sd_results> getPartialResults(const std::vector<bso::utilities::geometry::polyhedron*>& geoms);
 		
 		fea* getFEA() {return mFEA;}
 		fea* const getFEA() const {return mFEA;}
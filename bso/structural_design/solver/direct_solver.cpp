@@ -0,0 +1,86 @@
+#ifndef SD_DIRECT_SOLVER_CPP
+#define SD_DIRECT_SOLVER_CPP
+
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	bool is_direct_solver(const std::string& name)
+	{
+		return (name == "SimplicialLLT" || name == "SimplicialLDLT" ||
+						name == "CholmodSupernodalLLT" ||
+						name == "PardisoLLT" || name == "PardisoLDLT");
+	} // is_direct_solver()
+	
+	bool is_available(const std::string& name)
+	{
+		if (name == "CholmodSupernodalLLT")
+		{
+#ifdef BSO_USE_CHOLMOD
+			return true;
+#else
+			return false;
+#endif
+		}
+		else if (name == "PardisoLLT" || name == "PardisoLDLT")
+		{
+#ifdef BSO_USE_PARDISO
+			return true;
+#else
+			return false;
+#endif
+		}
+		return (name == "SimplicialLLT" || name == "SimplicialLDLT");
+	} // is_available()
+	
+	direct_solver* create_direct_solver(const std::string& name)
+	{
+		typedef Eigen::SparseMatrix<double> sparse_matrix;
+		if (name == "SimplicialLLT")
+		{
+			return new eigen_direct_solver<Eigen::SimplicialLLT<sparse_matrix> >(name);
+		}
+		else if (name == "CholmodSupernodalLLT")
+		{
+#ifdef BSO_USE_CHOLMOD
+			return new eigen_direct_solver<Eigen::CholmodSupernodalLLT<sparse_matrix> >(name);
+#else
+			return create_direct_solver("SimplicialLDLT");
+#endif
+		}
+		else if (name == "PardisoLLT")
+		{
+#ifdef BSO_USE_PARDISO
+			return new eigen_direct_solver<Eigen::PardisoLLT<sparse_matrix> >(name);
+#else
+			return create_direct_solver("SimplicialLDLT");
+#endif
+		}
+		else if (name == "PardisoLDLT")
+		{
+#ifdef BSO_USE_PARDISO
+			return new eigen_direct_solver<Eigen::PardisoLDLT<sparse_matrix> >(name);
+#else
+			return create_direct_solver("SimplicialLDLT");
+#endif
+		}
+		else if (name == "SimplicialLDLT")
+		{
+			return new eigen_direct_solver<Eigen::SimplicialLDLT<sparse_matrix> >(name);
+		}
+		else
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nTrying to create unknown direct solver:\n"
+									 << name << "\n"
+									 << "(bso/structural_design/solver/direct_solver.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+	} // create_direct_solver()
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_DIRECT_SOLVER_CPP
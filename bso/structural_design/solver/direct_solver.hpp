@@ -0,0 +1,72 @@
+#ifndef SD_DIRECT_SOLVER_HPP
+#define SD_DIRECT_SOLVER_HPP
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#ifdef BSO_USE_CHOLMOD
+#include <Eigen/CholmodSupport>
+#endif
+#ifdef BSO_USE_PARDISO
+#include <Eigen/PardisoSupport>
+#endif
+
+#include <string>
+
+namespace bso { namespace structural_design { namespace solver {
+	
+	/*
+	 * Interface to the sparse direct solvers that can factorize the global
+	 * stiffness matrix. The symbolic analysis (analyzePattern) is separate from
+	 * the numerical factorization (factorize), so it can be reused for matrices
+	 * with the same sparsity pattern.
+	 *
+	 * Available solvers:
+	 * "SimplicialLLT", "SimplicialLDLT": Eigen's simplicial Cholesky solvers
+	 * "CholmodSupernodalLLT": supernodal Cholesky of SuiteSparse's CHOLMOD,
+	 *     requires compiling with -DBSO_USE_CHOLMOD (and linking -lcholmod)
+	 * "PardisoLLT", "PardisoLDLT": multithreaded PARDISO solver of Intel's MKL,
+	 *     requires compiling with -DBSO_USE_PARDISO (and linking MKL)
+	 * When CHOLMOD or PARDISO are not available (see is_available()), SimplicialLDLT
+	 * is used instead.
+	 */
+	
+	class direct_solver
+	{
+	public:
+		virtual ~direct_solver() {}
+		
+		virtual void analyzePattern(const Eigen::SparseMatrix<double>& A) = 0;
+		virtual void factorize(const Eigen::SparseMatrix<double>& A) = 0;
+		virtual Eigen::MatrixXd solve(const Eigen::MatrixXd& B) const = 0;
+		virtual Eigen::ComputationInfo info() const = 0;
+		virtual std::string backendName() const = 0; // name of the solver that is actually used
+	};
+	
+	template <typename EIGEN_SOLVER>
+	class eigen_direct_solver : public direct_solver
+	{
+	private:
+		EIGEN_SOLVER mSolver;
+		std::string mBackendName;
+	public:
+		eigen_direct_solver(const std::string& backendName) : mBackendName(backendName) {}
+		
+		void analyzePattern(const Eigen::SparseMatrix<double>& A) {mSolver.analyzePattern(A);}
+		void factorize(const Eigen::SparseMatrix<double>& A) {mSolver.factorize(A);}
+		Eigen::MatrixXd solve(const Eigen::MatrixXd& B) const {return mSolver.solve(B);}
+		Eigen::ComputationInfo info() const {return mSolver.info();}
+		std::string backendName() const {return mBackendName;}
+	};
+	
+	bool is_direct_solver(const std::string& name); // true if name is one of the solvers listed above
+	bool is_available(const std::string& name); // true if the direct solver name is compiled in, rather than replaced by SimplicialLDLT
+	direct_solver* create_direct_solver(const std::string& name); // throws if name is not a direct solver
+	
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/direct_solver.cpp>
+
+#endif // SD_DIRECT_SOLVER_HPP
@@ -0,0 +1,137 @@
+#ifndef SD_MULTIGRID_CPP
+#define SD_MULTIGRID_CPP
+
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace solver {
+
+	multigrid_preconditioner::multigrid_preconditioner()
+	{
+
+	} // ctor()
+
+	template <typename MATRIX>
+	multigrid_preconditioner::multigrid_preconditioner(const MATRIX& A)
+	{
+		this->compute(A);
+	} // ctor()
+
+	multigrid_preconditioner::~multigrid_preconditioner()
+	{
+
+	} // dtor()
+
+	void multigrid_preconditioner::setProlongations(const std::vector<sparse_matrix>& prolongations)
+	{
+		for (unsigned int i = 1; i < prolongations.size(); ++i)
+		{
+			if (prolongations[i].rows() != prolongations[i-1].cols())
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nThe prolongation of multigrid level " << i+1 << " has " << prolongations[i].rows()
+										 << " rows,\nwhile level " << i << " has " << prolongations[i-1].cols() << " DOFs.\n"
+										 << "(bso/structural_design/solver/multigrid.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+		}
+		mProlongations = prolongations;
+		mCoarsePatternAnalyzed = false;
+	} // setProlongations()
+
+	template <typename MATRIX>
+	multigrid_preconditioner& multigrid_preconditioner::analyzePattern(const MATRIX&)
+	{ // the pattern of the coarsest operator follows from the first factorization
+		mCoarsePatternAnalyzed = false;
+		return *this;
+	} // analyzePattern()
+
+	template <typename MATRIX>
+	multigrid_preconditioner& multigrid_preconditioner::factorize(const MATRIX& A)
+	{
+		if (!mProlongations.empty() && mProlongations.front().rows() != A.rows())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nThe finest multigrid prolongation has " << mProlongations.front().rows()
+									 << " rows,\nwhile the system has " << A.rows() << " DOFs.\n"
+									 << "(bso/structural_design/solver/multigrid.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+
+		// Galerkin operators of the coarser levels
+		mMatrices.resize(mProlongations.size() + 1);
+		mDiagonals.resize(mProlongations.size());
+		mMatrices[0] = A;
+		for (unsigned int i = 0; i < mProlongations.size(); ++i)
+		{
+			mDiagonals[i] = mMatrices[i].diagonal();
+			sparse_matrix AP = mMatrices[i] * mProlongations[i];
+			mMatrices[i+1] = sparse_matrix(mProlongations[i].transpose()) * AP;
+		}
+
+		if (!mCoarsePatternAnalyzed)
+		{
+			mCoarseSolver.analyzePattern(mMatrices.back());
+			mCoarsePatternAnalyzed = true;
+		}
+		mCoarseSolver.factorize(mMatrices.back());
+		mInfo = mCoarseSolver.info();
+		return *this;
+	} // factorize()
+
+	template <typename MATRIX>
+	multigrid_preconditioner& multigrid_preconditioner::compute(const MATRIX& A)
+	{
+		this->analyzePattern(A);
+		return this->factorize(A);
+	} // compute()
+
+	void multigrid_preconditioner::smooth(const unsigned int& level, const Eigen::VectorXd& b,
+		Eigen::VectorXd& x, const bool& forward) const
+	{ // the operators are symmetric, so column i holds the coefficients of row i
+		const sparse_matrix& A = mMatrices[level];
+		const Eigen::VectorXd& diagonal = mDiagonals[level];
+		long n = A.cols();
+		for (long k = 0; k < n; ++k)
+		{
+			long i = forward ? k : n - 1 - k;
+			if (diagonal(i) == 0) continue;
+			double residual = b(i);
+			for (sparse_matrix::InnerIterator it(A,i); it; ++it) residual -= it.value() * x(it.row());
+			x(i) += residual / diagonal(i);
+		}
+	} // smooth()
+
+	void multigrid_preconditioner::vCycle(const unsigned int& level, const Eigen::VectorXd& b,
+		Eigen::VectorXd& x) const
+	{
+		if (level == mProlongations.size())
+		{
+			x = mCoarseSolver.solve(b);
+			return;
+		}
+		x.setZero(b.size());
+		for (unsigned int i = 0; i < mSmoothingSteps; ++i) this->smooth(level, b, x, true);
+
+		Eigen::VectorXd residual = b - mMatrices[level] * x;
+		Eigen::VectorXd coarseResidual = mProlongations[level].transpose() * residual;
+		Eigen::VectorXd coarseCorrection;
+		this->vCycle(level + 1, coarseResidual, coarseCorrection);
+		x += mProlongations[level] * coarseCorrection;
+
+		for (unsigned int i = 0; i < mSmoothingSteps; ++i) this->smooth(level, b, x, false);
+	} // vCycle()
+
+	template <typename RHS>
+	Eigen::VectorXd multigrid_preconditioner::solve(const Eigen::MatrixBase<RHS>& b) const
+	{
+		Eigen::VectorXd x;
+		this->vCycle(0, b, x);
+		return x;
+	} // solve()
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_MULTIGRID_CPP
@@ -0,0 +1,68 @@
+#ifndef SD_MULTIGRID_HPP
+#define SD_MULTIGRID_HPP
+
+#include <Eigen/Sparse>
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace solver {
+
+	/*
+	 * Geometric multigrid preconditioner for Eigen's ConjugateGradient. The
+	 * prolongations interpolate the DOFs of each coarser level to the next
+	 * finer one (level 0 is the system itself), the coarse operators are the
+	 * Galerkin products P^T A P. One application is a V-cycle with symmetric
+	 * Gauss-Seidel smoothing (forward before, backward after the coarse
+	 * correction) and a direct solve on the coarsest level, so the
+	 * preconditioner is symmetric positive definite. Without prolongations the
+	 * system itself is solved directly.
+	 */
+
+	class multigrid_preconditioner
+	{
+	private:
+		typedef Eigen::SparseMatrix<double> sparse_matrix;
+
+		std::vector<sparse_matrix> mProlongations; // level l from level l+1
+		std::vector<sparse_matrix> mMatrices; // the operator of each level
+		std::vector<Eigen::VectorXd> mDiagonals; // the diagonal of each operator, but the coarsest
+		Eigen::SimplicialLDLT<sparse_matrix> mCoarseSolver;
+		bool mCoarsePatternAnalyzed = false;
+		unsigned int mSmoothingSteps = 2;
+		Eigen::ComputationInfo mInfo = Eigen::Success;
+
+		void smooth(const unsigned int& level, const Eigen::VectorXd& b, Eigen::VectorXd& x,
+			const bool& forward) const; // one Gauss-Seidel sweep
+		void vCycle(const unsigned int& level, const Eigen::VectorXd& b, Eigen::VectorXd& x) const;
+	public:
+		multigrid_preconditioner();
+		template <typename MATRIX>
+		explicit multigrid_preconditioner(const MATRIX& A);
+		~multigrid_preconditioner();
+
+		void setProlongations(const std::vector<sparse_matrix>& prolongations);
+		void setSmoothingSteps(const unsigned int& steps) {mSmoothingSteps = steps;}
+
+		// interface of Eigen's preconditioners, A must be stored as a full symmetric matrix
+		template <typename MATRIX>
+		multigrid_preconditioner& analyzePattern(const MATRIX& A);
+		template <typename MATRIX>
+		multigrid_preconditioner& factorize(const MATRIX& A);
+		template <typename MATRIX>
+		multigrid_preconditioner& compute(const MATRIX& A);
+		template <typename RHS>
+		Eigen::VectorXd solve(const Eigen::MatrixBase<RHS>& b) const;
+		Eigen::ComputationInfo info() const {return mInfo;}
+
+		unsigned int levelCount() const {return mProlongations.size() + 1;}
+		const sparse_matrix& getOperator(const unsigned int& level) const {return mMatrices[level];}
+	};
+
+} // namespace solver
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/solver/multigrid.cpp>
+
+#endif // SD_MULTIGRID_HPP
@@ -141,9 +141,6 @@ namespace bso { namespace structural_design { namespace topology_optimization {
 		Eigen::VectorXd eeen, eeem;
 		eeen.setOnes(n);
 		eeem.setOnes(m);
-		Eigen::MatrixXd eemmat, eenmat;
-		eemmat.setIdentity(m,m);	// required at line 256 to enable summation
-		eenmat.setIdentity(n,n);	// required at line 273 to enable summation
 		Eigen::VectorXd x = 0.5 * (alfa + beta);
 		Eigen::VectorXd y, lam, s;
 		y.setOnes(m);
@@ -177,8 +174,8 @@ namespace bso { namespace structural_design { namespace topology_optimization {
 		// initialize containers line 250 - 289 (if-statement)
 		Eigen::VectorXd blam1(m), blam2(n), blam(m);
 		Eigen::VectorXd diaglamyiinv(m), dellamyi(m), axz(n), bx(n);
-		Eigen::MatrixXd Alam(m,m), AA(m + 1, m + 1), Axx(n,n), AxA(n + 1, n + 1);
-		Eigen::VectorXd bb(m + 1), solut(m + 1), bxb(n + 1), solution(n + 1);
+		Eigen::MatrixXd Alam, AA, Axx, AxA; // sized in the branch that is used, Axx and AxA are (n,n)
+		Eigen::VectorXd bb(m + 1), solut(m + 1), bxb, solution;
 		Eigen::VectorXd dlam1(m), dlam(m), dx1(n), dx(n);
 		double dz, azz, bz;
 		// initialize containers line 290 - 322
@@ -204,14 +201,14 @@ namespace bso { namespace structural_design { namespace topology_optimization {
 			dpsidx = plam.cwiseQuotient(ux22) - qlam.cwiseQuotient(xl22);
 			gvec = P * uxinv1 + Q * xlinv1;
 			rex = dpsidx - xsi + eta;
-			rey = cmma + (dmma * y.transpose()).diagonal() - mu - lam;
+			rey = cmma + dmma.cwiseProduct(y) - mu - lam;
 			rez = a0 - zet - amma.transpose() * lam;
 			relam = gvec - z * amma - y + s - bmma;
-			rexsi = ((x - alfa) * xsi.transpose()).diagonal() - epsvecn;
-			reeta = ((beta - x) * eta.transpose()).diagonal() - epsvecn;
-			remu = (mu * y.transpose()).diagonal() - epsvecm;
+			rexsi = (x - alfa).cwiseProduct(xsi) - epsvecn;
+			reeta = (beta - x).cwiseProduct(eta) - epsvecn;
+			remu = mu.cwiseProduct(y) - epsvecm;
 			rezet = zet * z - epsi;
-			res = (lam * s.transpose()).diagonal() - epsvecm;
+			res = lam.cwiseProduct(s) - epsvecm;
 			residu1 << rex, rey, rez;
 			residu2 << relam, rexsi, reeta, remu, rezet, res;
 			residu << residu1, residu2;
@@ -256,12 +253,14 @@ namespace bso { namespace structural_design { namespace topology_optimization {
 					blam2 = delx.cwiseQuotient(diagx);
 					blam = blam1 - GG * blam2;
 					bb << blam, delz;
-					Alam = eemmat * diaglamyi.asDiagonal() + GG * diagxinv.asDiagonal() * GG.transpose();
+					Alam = GG * diagxinv.asDiagonal() * GG.transpose();
+					Alam.diagonal() += diaglamyi;
+					AA.resize(m + 1, m + 1);
 					AA.block(0,0,m,m) = Alam;
 					AA.block(0,m,m,1) = amma;
 					AA.block(m,0,1,m) = amma.transpose();
 					AA(m,m) = -1.0 * zet / z;
-					solut = AA.llt().solve(bb);
+					solut = AA.partialPivLu().solve(bb); // AA is indefinite: AA(m,m) < 0
 					dlam = solut.head(m);
 					dz = solut(m);
 					dx1 = (GG.transpose() * dlam);
@@ -273,7 +272,10 @@ namespace bso { namespace structural_design { namespace topology_optimization {
 					dellamyi = dellam + dely.cwiseQuotient(diagy);
 					blam = amma.cwiseQuotient(diaglamyi);
 					blam1 = dellamyi.cwiseQuotient(diaglamyi);
-					Axx = eenmat * diagx.asDiagonal() + GG.transpose() * diaglamyiinv.asDiagonal() * GG;
+					Axx = GG.transpose() * diaglamyiinv.asDiagonal() * GG;
+					Axx.diagonal() += diagx;
+					AxA.resize(n + 1, n + 1);
+					bxb.resize(n + 1);
 					azz = zet / z + amma.transpose() * blam;
 					axz = -1.0 * GG.transpose() * blam;
 					bx = delx + GG.transpose() * blam1;
@@ -345,14 +347,14 @@ namespace bso { namespace structural_design { namespace topology_optimization {
 					dpsidx = plam.cwiseQuotient(ux22) - qlam.cwiseQuotient(xl22);
 					gvec = P * uxinv1 + Q * xlinv1;
 					rex = dpsidx - xsi + eta;
-					rey = cmma + (dmma * y.transpose()).diagonal() - mu - lam;
+					rey = cmma + dmma.cwiseProduct(y) - mu - lam;
 					rez = a0 - zet - amma.transpose() * lam;
 					relam = gvec - z * amma - y + s - bmma;
-					rexsi = ((x - alfa) * xsi.transpose()).diagonal() - epsvecn;
-					reeta = ((beta - x) * eta.transpose()).diagonal() - epsvecn;
-					remu = (mu * y.transpose()).diagonal() - epsvecm;
+					rexsi = (x - alfa).cwiseProduct(xsi) - epsvecn;
+					reeta = (beta - x).cwiseProduct(eta) - epsvecn;
+					remu = mu.cwiseProduct(y) - epsvecm;
 					rezet = zet * z - epsi;
-					res = (lam * s.transpose()).diagonal() - epsvecm;
+					res = lam.cwiseProduct(s) - epsvecm;
 					residu1 << rex, rey, rez;
 					residu2 << relam, rexsi, reeta, remu, rezet, res;
 					residu << residu1, residu2;
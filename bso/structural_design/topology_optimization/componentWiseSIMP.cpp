@@ -1,19 +1,28 @@
 #ifndef SD_TOPOPT_COMPONENT_WISE_SIMP_CPP
 #define SD_TOPOPT_COMPONENT_WISE_SIMP_CPP
 
+#include <bso/utilities/parallel_for.hpp>
+
 namespace bso { namespace structural_design { namespace topology_optimization {
 
 class COMP_SIMP;
 
 namespace comp_simp {
-void ObjectiveAndSensitivity(
-		 const std::map<component::geometry*, std::vector<element::element*>>& elePerComp,
-		 double& c, const Eigen::VectorXd& x, Eigen::VectorXd& dc, Eigen::VectorXd& dv,
-		 const double& penal);
-void OptimalityCritUpdate(double l1, double l2, const double& xMove, 
-		 const double& totalVolume, const double& f, Eigen::VectorXd& volume,
-		 Eigen::VectorXd& x, Eigen::VectorXd& xNew, const Eigen::VectorXd& dv,
-		 const Eigen::VectorXd& dc);
+
+struct component_group
+{ // the elements of one type, grouped per component, each component has one design variable
+	std::map<component::geometry*, std::vector<element::element*>> mComponents;
+	double mTotalVolume = 0; // initialised at 0, before each element volumes are added
+	unsigned int mEnergyBatch;
+	std::vector<unsigned int> mCompIndices; // component of each element in the energy batch
+	Eigen::VectorXd mX, mXNew, mVolume, mDC, mDV;
+	double mC; // sum of the compliances of the elements in this group
+	double mChange;
+};
+
+void GroupInit(optimization_driver& driver, component_group& group, const double& f);
+void GroupUpdate(optimization_driver& driver, const optimality_criteria& OC,
+		 component_group& group, const double& f, const double& penal);
 
 } // namespace comp_simp
 } // namespace topology_optimization
@@ -24,235 +33,123 @@ void sd_model::topologyOptimization<topology_optimization::COMP_SIMP>(
 			const double& tolerance)
 {
 	using namespace topology_optimization::comp_simp;
-	std::ostream out(mTopOptStreamBuffer);
-	std::map<component::geometry*, std::vector<element::element*>> fComp, bComp, tComp;
-	double fVolume = 0, bVolume= 0, tVolume = 0, totVolume = 0; // initialised at 0, before each element volumes are added
-	double cF, cB, cT; // sum of all the elements compliances (objective values)
-	
-	std::vector<element::element*> fEle, bEle, tEle;
+	topology_optimization::optimization_driver driver(mFEA, mTopOptStreamBuffer, mTopOptSolver);
+	topology_optimization::optimality_criteria OC(xMove);
+	std::vector<component_group> groups(3); // flat shells, beams and trusses
+	double totVolume = 0;
+
 	for (auto& i : mGeometries)
 	{
-		fEle.clear(); bEle.clear(); tEle.clear();
 		for (auto& j : i->getElements())
 		{
 			if (!j->isActiveInCompliance()) continue;
 			j->updateDensity(f,penal);
-			if (j->isFlatShell())
-			{
-				fEle.push_back(j);
-				fVolume += j->getVolume();
-			}
-			else if (j->isBeam())
-			{
-				bEle.push_back(j);
-				bVolume += j->getVolume();
-			}
-			else if (j->isTruss())
-			{
-				tEle.push_back(j);
-				tVolume += j->getVolume();
-			}
+			component_group* group;
+			if (j->isFlatShell()) group = &groups[0];
+			else if (j->isBeam()) group = &groups[1];
+			else if (j->isTruss()) group = &groups[2];
+			else continue;
+			group->mComponents[i].push_back(j);
+			group->mTotalVolume += j->getVolume();
 		}
-		if (!fEle.empty()) fComp[i] = fEle;
-		if (!bEle.empty()) bComp[i] = bEle;
-		if (!tEle.empty()) tComp[i] = tEle;
-	}
-	unsigned int numFComp = fComp.size(), numBComp = bComp.size(), numTComp = tComp.size();
-	
-	// initialise containers for element values
-	Eigen::VectorXd xF(numFComp),       xB(numBComp),       xT(numTComp),
-									xNewF(numFComp),    xNewB(numBComp),    xNewT(numTComp),
-									xChangeF(numFComp), xChangeB(numBComp), xChangeT(numTComp),
-									volumeF(numFComp),  volumeB(numBComp),  volumeT(numTComp),
-									dcF(numFComp),      dcB(numBComp),      dcT(numTComp),
-									dvF(numFComp),      dvB(numBComp),      dvT(numTComp);
-	xChangeF.setZero(); xChangeB.setZero(); xChangeT.setZero();
-	
-	unsigned int compIndexI = 0;
-	for (auto& i : fComp)
-	{
-		xF(compIndexI) = f;
-		volumeF(compIndexI) = 0;
-		for (auto& j : i.second) volumeF(compIndexI) += j->getVolume();
-		++compIndexI;
-	}
-	compIndexI = 0;
-	for (auto& i : bComp)
-	{
-		xB(compIndexI) = f;
-		volumeB(compIndexI) = 0;
-		for (auto& j : i.second) volumeB(compIndexI) += j->getVolume();
-		++compIndexI;
 	}
-	compIndexI = 0;
-	for (auto& i : tComp)
+	groups.erase(std::remove_if(groups.begin(), groups.end(),
+		[](const component_group& g) {return g.mComponents.empty();}), groups.end());
+
+	for (auto& i : groups)
 	{
-		xT(compIndexI) = f;
-		volumeT(compIndexI) = 0;
-		for (auto& j : i.second) volumeT(compIndexI) += j->getVolume();
-		++compIndexI;
+		GroupInit(driver,i,f);
+		totVolume += i.mTotalVolume;
 	}
-	
-	totVolume = fVolume+bVolume+tVolume;
-	out << "Total Volume: " << totVolume << std::endl;
+	driver.out() << "Total Volume: " << totVolume << std::endl;
 
 	// initialise iteration
 	double change = 1;
-	int loop = 0;
-
-	double loopStart = clock(), iterationStart, timeEnd = 0.0;
+	driver.setColumns({{"loop",5},{"Objective",15},{"Volume",15},{"Change",15},{"Time",10}});
 
 	// start iteration
 	while (change > tolerance)
 	{
-		iterationStart = clock();
-		if (loop%20 == 0)
-		{
-			out << std::endl
-					<< std::setw(5)  << std::left << "loop"
-					<< std::setw(15) << std::left << "Objective"
-					<< std::setw(15) << std::left << "Volume"
-					<< std::setw(15) << std::left << "Change"
-					<< std::setw(10) << std::left << "Time" << std::endl;
-		}
-
-		++loop;
-		cF = cB = cT = 0;
+		driver.startIteration();
 
 		// FEA
-		mFEA->generateGSM();
-		mFEA->solve("SimplicialLDLT");
+		driver.solve();
 
-		double volume = 0;
-		if (fComp.size() > 0)
-		{
-			ObjectiveAndSensitivity(fComp,cF,xF,dcF,dvF,penal);
-			OptimalityCritUpdate(0,1e9,xMove,fVolume,f,volumeF,xF,xNewF,dvF,dcF);
-			
-			unsigned int compIndexI = 0;
-			for (auto& i : fComp)
-			{
-				for (auto& j : i.second) j->updateDensity(xNewF(compIndexI), penal);
-				++compIndexI;
-			}
-			xChangeF = xNewF - xF;
-			volume += (volumeF * xNewF.transpose()).trace();
-		}
-		if (bComp.size() > 0)
-		{
-			ObjectiveAndSensitivity(bComp,cB,xB,dcB,dvB,penal);
-			OptimalityCritUpdate(0,1e9,xMove,bVolume,f,volumeB,xB,xNewB,dvB,dcB);
-			
-			unsigned int compIndexI = 0;
-			for (auto& i : bComp)
-			{
-				for (auto& j : i.second) j->updateDensity(xNewB(compIndexI), penal);
-				++compIndexI;
-			}
-			xChangeB = xNewB - xB;
-			volume += (volumeB * xNewB.transpose()).trace();
-		}
-		if (tComp.size() > 0)
+		// sensitivities and optimality criteria update of each group, the groups are independent
+		bso::utilities::parallel_for(0, groups.size(), driver.getThreadCount(),
+			[&](const unsigned long& i)
 		{
-			ObjectiveAndSensitivity(tComp,cT,xT,dcT,dvT,penal);
-			OptimalityCritUpdate(0,1e9,xMove,tVolume,f,volumeT,xT,xNewT,dvT,dcT);
-			
-			unsigned int compIndexI = 0;
-			for (auto& i : tComp)
-			{
-				for (auto& j : i.second) j->updateDensity(xNewT(compIndexI), penal);
-				++compIndexI;
-			}
-			xChangeT = xNewT - xT;
-			volume += (volumeT * xNewT.transpose()).trace();
-		}
+			GroupUpdate(driver,OC,groups[i],f,penal);
+		});
 
-		// update change
+		double c = 0, volume = 0;
 		change = 0;
-		if (fComp.size() > 0)
-		{
-			change = std::max(change, xChangeF.cwiseAbs().maxCoeff());
-		}
-		if (bComp.size() > 0)
-		{
-			change = std::max(change, xChangeB.cwiseAbs().maxCoeff());
-		}
-		if (tComp.size() > 0)
+		for (auto& i : groups)
 		{
-			change = std::max(change, xChangeT.cwiseAbs().maxCoeff());
+			c += i.mC;
+			volume += i.mVolume.dot(i.mXNew);
+			change = std::max(change, i.mChange);
+			i.mX = i.mXNew;
 		}
 
-		timeEnd = clock();
-		out << std::setw(5)  << std::left << loop
-				<< std::setw(15) << std::left << cF + cB + cT
-				<< std::setw(15) << std::left << volume
-				<< std::setw(15) << std::left << change
-				<< std::setw(10) << std::left << (timeEnd - iterationStart)/CLOCKS_PER_SEC << std::endl;
-
-		xF = xNewF;
-		xB = xNewB;
-		xT = xNewT;
+		driver.logIteration({(double)driver.iteration(), c, volume, change});
 	} // end of iteration
-	out << "Topology optimisation successfully finished after: "
-			<< (timeEnd - loopStart)/CLOCKS_PER_SEC << " seconds."
-			<< std::endl << std::endl;
+	driver.finish();
 }
 
 namespace topology_optimization { namespace comp_simp {
-	
-	
-void ObjectiveAndSensitivity(
-		 const std::map<component::geometry*, std::vector<element::element*>>& elePerComp,
-		 double& c, const Eigen::VectorXd& x, Eigen::VectorXd& dc, Eigen::VectorXd& dv,
-		 const double& penal)
+
+
+void GroupInit(optimization_driver& driver, component_group& group, const double& f)
 {
-	// objective function and sensitivity analysis (retrieve data from FEA)
+	unsigned int numComp = group.mComponents.size();
+	group.mX.setConstant(numComp, f);
+	group.mXNew = group.mX;
+	group.mVolume.setZero(numComp);
+	group.mDC.resize(numComp);
+
+	std::vector<element::element*> elements;
+	group.mCompIndices.clear();
 	unsigned int compIndexI = 0;
-	for (const auto& i : elePerComp)
+	for (const auto& i : group.mComponents)
 	{
-		dc(compIndexI) =  0; 
-		dv(compIndexI) =  0;
 		for (const auto& j : i.second)
 		{
-			c 						 += j->getTotalEnergy();
-			dc(compIndexI) += j->getEnergySensitivity(penal); 
-			dv(compIndexI) += j->getVolume();
+			group.mVolume(compIndexI) += j->getVolume();
+			elements.push_back(j);
+			group.mCompIndices.push_back(compIndexI);
 		}
 		++compIndexI;
 	}
-
-	dc = (dc * x.transpose()).diagonal();
+	group.mEnergyBatch = driver.addEnergyBatch(elements);
 }
 
-void OptimalityCritUpdate(double l1, double l2, const double& xMove, 
-		 const double& totalVolume, const double& f, Eigen::VectorXd& volume,
-		 Eigen::VectorXd& x, Eigen::VectorXd& xNew, const Eigen::VectorXd& dv,
-		 const Eigen::VectorXd& dc)
+void GroupUpdate(optimization_driver& driver, const optimality_criteria& OC,
+		 component_group& group, const double& f, const double& penal)
 {
-	// optimality criteria update of design variables and physical densities
-	double lmid, upper, lower;
-	while (((l2-l1)/(l1+l2))>1e-3)
-	{
-		lmid = (l1+l2)/2.0;
-
-		for (unsigned int i = 0; i < x.size(); i++)
-		{
-			xNew(i) = x(i) * (std::sqrt(-dc(i)/(lmid*dv(i))));
-			upper = std::min(1.0, (x(i) + xMove));
-			lower = std::max(0.0, (x(i) - xMove));
+	// objective function and sensitivity analysis (retrieve data from FEA)
+	const std::vector<unsigned int>& compIndices = group.mCompIndices;
+	Eigen::VectorXd densities(compIndices.size());
+	for (unsigned long i = 0; i < compIndices.size(); ++i) densities(i) = group.mX(compIndices[i]);
+	const element::element_batch& energies = driver.computeEnergies(group.mEnergyBatch, densities, penal);
+	group.mC = energies.getTotalEnergy();
+
+	const Eigen::VectorXd& elementSensitivities = energies.getEnergySensitivities();
+	group.mDC.setZero();
+	for (unsigned long i = 0; i < compIndices.size(); ++i) group.mDC(compIndices[i]) += elementSensitivities(i);
+	group.mDV = group.mVolume;
+	group.mDC = group.mDC.cwiseProduct(group.mX);
 
-			if (xNew(i) > upper)
-			{
-				xNew(i) = upper;
-			}
-			else if (xNew(i) < lower)
-			{
-				xNew(i) = lower;
-			}
-		}
+	// optimality criteria update of design variables and physical densities
+	OC.update(group.mX, group.mXNew, group.mDC, group.mDV, group.mVolume, f * group.mTotalVolume);
 
-		((volume * xNew.transpose()).trace() > f * totalVolume) ? l1 = lmid : l2 = lmid;
+	unsigned int compIndexI = 0;
+	for (auto& i : group.mComponents)
+	{
+		for (auto& j : i.second) j->updateDensity(group.mXNew(compIndexI), penal);
+		++compIndexI;
 	}
+	group.mChange = (group.mXNew - group.mX).cwiseAbs().maxCoeff();
 }
 
 } // namespace comp_simp
@@ -260,4 +157,4 @@ void OptimalityCritUpdate(double l1, double l2, const double& xMove,
 } // namespace structural_design
 } // bso
 
-#endif // SD_TOPOPT_COMPONENT_WISE_SIMP_CPP
\ No newline at end of file
+#endif // SD_TOPOPT_COMPONENT_WISE_SIMP_CPP
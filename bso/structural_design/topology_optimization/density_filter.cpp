@@ -0,0 +1,135 @@
+#ifndef SD_TOPOPT_DENSITY_FILTER_CPP
+#define SD_TOPOPT_DENSITY_FILTER_CPP
+
+#include <bso/utilities/aabb_tree.hpp>
+#include <bso/utilities/parallel_for.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	void build_density_filters(const Eigen::Matrix3Xd& centers, const std::vector<unsigned int>& groups,
+		const double& rMin, std::vector<Eigen::SparseMatrix<double> >& H, std::vector<Eigen::VectorXd>& Hs,
+		const unsigned int& threadCount /*= 1*/)
+	{
+		if (!(rMin > 0) || groups.size() != (unsigned long)centers.cols())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot build a density filter with a filter radius of: " << rMin << "\n"
+									 << "for " << centers.cols() << " elements in " << groups.size() << " groups.\n"
+									 << "(bso/structural_design/topology_optimization/density_filter.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+
+		// the index of each element in its group
+		unsigned long numEle = centers.cols();
+		unsigned int groupCount = groups.empty() ? 0 : *std::max_element(groups.begin(), groups.end()) + 1;
+		std::vector<unsigned long> groupSizes(groupCount, 0), localIndices(numEle);
+		for (unsigned long i = 0; i < numEle; ++i) localIndices[i] = groupSizes[groups[i]]++;
+
+		// the neighbours of each element in its own group and their weights, in ascending order of the neighbours
+		std::vector<std::vector<std::pair<unsigned long, double> > > rows(numEle);
+		std::vector<double> rowSums(numEle, 0.0);
+		if (numEle > 0)
+		{
+			bso::utilities::aabb_tree centerTree;
+			centerTree.build(centers, centers);
+			bso::utilities::parallel_for(0, numEle, threadCount, [&](const unsigned long& i)
+			{
+				Eigen::Vector3d center = centers.col(i);
+				double reach = rMin + 1e-9*(center.cwiseAbs().maxCoeff() + rMin); // margin for the rounding of the box corners
+				std::vector<unsigned long> candidates;
+				centerTree.findIntersecting(center.array() - reach, center.array() + reach, candidates);
+				for (const auto& j : candidates)
+				{
+					if (groups[j] != groups[i]) continue;
+					double rij = (centers.col(j) - center).norm();
+					if (rij < rMin)
+					{
+						rows[i].push_back(std::make_pair(localIndices[j], rMin - rij));
+						rowSums[i] += rMin - rij;
+					}
+				}
+			});
+		}
+
+		typedef Eigen::Triplet<double> T;
+		std::vector<std::vector<T> > tripletLists(groupCount);
+		H.resize(groupCount);
+		Hs.resize(groupCount);
+		for (unsigned int k = 0; k < groupCount; ++k) Hs[k].setZero(groupSizes[k]);
+		for (unsigned long i = 0; i < numEle; ++i)
+		{
+			for (const auto& j : rows[i]) tripletLists[groups[i]].push_back(T(localIndices[i], j.first, j.second));
+			Hs[groups[i]](localIndices[i]) = rowSums[i];
+		}
+		for (unsigned int k = 0; k < groupCount; ++k)
+		{
+			H[k].resize(groupSizes[k], groupSizes[k]);
+			H[k].setFromTriplets(tripletLists[k].begin(), tripletLists[k].end());
+		}
+	} // build_density_filters()
+
+	void build_density_filters(const std::vector<std::vector<element::element*> >& groups, const double& rMin,
+		std::vector<Eigen::SparseMatrix<double> >& H, std::vector<Eigen::VectorXd>& Hs,
+		const unsigned int& threadCount /*= 1*/)
+	{
+		unsigned long numEle = 0;
+		for (const auto& i : groups) numEle += i.size();
+		Eigen::Matrix3Xd centers(3, numEle);
+		std::vector<unsigned int> groupIndices;
+		groupIndices.reserve(numEle);
+		for (unsigned int k = 0; k < groups.size(); ++k)
+		{
+			for (const auto& i : groups[k])
+			{
+				centers.col(groupIndices.size()) = i->getCenter();
+				groupIndices.push_back(k);
+			}
+		}
+		build_density_filters(centers, groupIndices, rMin, H, Hs, threadCount);
+		H.resize(groups.size()); // trailing empty groups
+		Hs.resize(groups.size());
+	} // build_density_filters()
+
+	void build_density_filter(const Eigen::Matrix3Xd& centers, const double& rMin,
+		Eigen::SparseMatrix<double>& H, Eigen::VectorXd& Hs, const unsigned int& threadCount /*= 1*/)
+	{
+		std::vector<Eigen::SparseMatrix<double> > groupH;
+		std::vector<Eigen::VectorXd> groupHs;
+		build_density_filters(centers, std::vector<unsigned int>(centers.cols(), 0), rMin, groupH, groupHs, threadCount);
+		if (groupH.empty())
+		{
+			H.resize(0,0);
+			Hs.resize(0);
+		}
+		else
+		{
+			H = std::move(groupH[0]);
+			Hs = std::move(groupHs[0]);
+		}
+	} // build_density_filter()
+
+	void build_density_filter(const std::vector<element::element*>& elements, const double& rMin,
+		Eigen::SparseMatrix<double>& H, Eigen::VectorXd& Hs, const unsigned int& threadCount /*= 1*/)
+	{
+		Eigen::Matrix3Xd centers(3, elements.size());
+		for (unsigned long i = 0; i < elements.size(); ++i) centers.col(i) = elements[i]->getCenter();
+		build_density_filter(centers, rMin, H, Hs, threadCount);
+	} // build_density_filter()
+
+	void filter_sensitivities(const Eigen::SparseMatrix<double>& H, const Eigen::VectorXd& Hs,
+		const Eigen::VectorXd& x, Eigen::VectorXd& dc)
+	{
+		dc = H * dc.cwiseProduct(x);
+		dc = dc.cwiseQuotient(Hs.cwiseProduct(x.cwiseMax(1e-3)));
+	} // filter_sensitivities()
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_TOPOPT_DENSITY_FILTER_CPP
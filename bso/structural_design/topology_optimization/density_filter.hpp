@@ -0,0 +1,43 @@
+#ifndef SD_TOPOPT_DENSITY_FILTER_HPP
+#define SD_TOPOPT_DENSITY_FILTER_HPP
+
+#include <bso/structural_design/element/element.hpp>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	/*
+	 * Builds the linear density filter of a set of elements:
+	 * H(i,j) = rMin - r_ij for each pair of elements of which the center to
+	 * center distance r_ij is smaller than rMin, and Hs(i) is the sum of row i.
+	 * The neighbours of each element are found with an AABB tree over the
+	 * element centers, the rows are computed in parallel with threadCount threads.
+	 */
+
+	void build_density_filter(const Eigen::Matrix3Xd& centers, const double& rMin,
+		Eigen::SparseMatrix<double>& H, Eigen::VectorXd& Hs, const unsigned int& threadCount = 1);
+	void build_density_filter(const std::vector<element::element*>& elements, const double& rMin,
+		Eigen::SparseMatrix<double>& H, Eigen::VectorXd& Hs, const unsigned int& threadCount = 1);
+	// the density filters of several groups of elements with one neighbour search: the
+	// elements of each group are only filtered with the elements of the same group
+	void build_density_filters(const Eigen::Matrix3Xd& centers, const std::vector<unsigned int>& groups,
+		const double& rMin, std::vector<Eigen::SparseMatrix<double> >& H, std::vector<Eigen::VectorXd>& Hs,
+		const unsigned int& threadCount = 1);
+	void build_density_filters(const std::vector<std::vector<element::element*> >& groups, const double& rMin,
+		std::vector<Eigen::SparseMatrix<double> >& H, std::vector<Eigen::VectorXd>& Hs,
+		const unsigned int& threadCount = 1);
+	// sensitivity filter of Sigmund: dc = H*(x.*dc) ./ (Hs.*max(1e-3,x))
+	void filter_sensitivities(const Eigen::SparseMatrix<double>& H, const Eigen::VectorXd& Hs,
+		const Eigen::VectorXd& x, Eigen::VectorXd& dc);
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/topology_optimization/density_filter.cpp>
+
+#endif // SD_TOPOPT_DENSITY_FILTER_HPP
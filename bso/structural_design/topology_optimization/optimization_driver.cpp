@@ -0,0 +1,198 @@
+#ifndef SD_TOPOPT_OPTIMIZATION_DRIVER_CPP
+#define SD_TOPOPT_OPTIMIZATION_DRIVER_CPP
+
+#include <bso/structural_design/topology_optimization/density_filter.hpp>
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	optimization_driver::optimization_driver(fea* FEA, std::streambuf* out,
+		const std::string& solver /*= "SimplicialLDLT"*/)
+	: mFEA(FEA), mOut(out), mSolver(solver)
+	{
+		mStart = clock_type::now();
+		mIterationStart = mStart;
+	} // ctor()
+
+	optimization_driver::~optimization_driver()
+	{
+
+	} // dtor()
+
+	unsigned int optimization_driver::getThreadCount() const
+	{
+		return mFEA->isParallel() ? mFEA->getThreadCount() : 1;
+	} // getThreadCount()
+
+	void optimization_driver::buildFilter(const std::vector<element::element*>& elements,
+		const double& rMin, Eigen::SparseMatrix<double>& H, Eigen::VectorXd& Hs) const
+	{
+		build_density_filter(elements, rMin, H, Hs, this->getThreadCount());
+	} // buildFilter()
+
+	void optimization_driver::buildFilters(const std::vector<std::vector<element::element*> >& groups,
+		const double& rMin, std::vector<Eigen::SparseMatrix<double> >& H, std::vector<Eigen::VectorXd>& Hs) const
+	{
+		build_density_filters(groups, rMin, H, Hs, this->getThreadCount());
+	} // buildFilters()
+
+	unsigned int optimization_driver::addEnergyBatch(const std::vector<element::element*>& elements)
+	{
+		mBatchElements.push_back(elements);
+		mBatches.push_back(element::element_batch());
+		mBatchesBuilt = false;
+		return mBatches.size() - 1;
+	} // addEnergyBatch()
+
+	void optimization_driver::buildBatches()
+	{
+		if (mBatchesBuilt) return;
+		for (unsigned int i = 0; i < mBatches.size(); ++i)
+		{
+			if (mBatches[i].size() != mBatchElements[i].size()) mBatches[i].build(mBatchElements[i]);
+		}
+		mBatchesBuilt = true;
+	} // buildBatches()
+
+	void optimization_driver::solve()
+	{
+		mFEA->generateGSM();
+		mFEA->solve(mSolver);
+		this->buildBatches();
+	} // solve()
+
+	void optimization_driver::solveRealizations(const std::vector<Eigen::VectorXd>& densities,
+		const double& penal)
+	{
+		const auto& elements = mFEA->getElements();
+		std::vector<Eigen::VectorXd> stiffnessFactors(densities.size());
+		for (unsigned int i = 0; i < densities.size(); ++i)
+		{
+			if ((unsigned long)densities[i].size() != elements.size())
+			{
+				std::stringstream errorMessage;
+				errorMessage << "\nCannot solve a realization with " << densities[i].size() << " densities\n"
+										 << "for an FEA system with " << elements.size() << " elements.\n"
+										 << "(bso/structural_design/topology_optimization/optimization_driver.cpp)" << std::endl;
+				throw std::invalid_argument(errorMessage.str());
+			}
+			stiffnessFactors[i].resize(elements.size());
+			for (unsigned long j = 0; j < elements.size(); ++j)
+			{ // modified SIMP: E/E0 = Emin/E0 + x^p (1 - Emin/E0)
+				double rMin = elements[j]->getMinimumStiffnessFactor();
+				stiffnessFactors[i](j) = rMin + std::pow(densities[i](j), penal)*(1 - rMin);
+			}
+		}
+		mFEA->solveRealizations(stiffnessFactors, mRealizationDisplacements, mSolver);
+		this->buildBatches();
+	} // solveRealizations()
+
+	void optimization_driver::applyRealization(const unsigned int& realization)
+	{
+		if (realization >= mRealizationDisplacements.size())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot apply realization: " << realization << "\n"
+									 << "it has not been solved yet.\n"
+									 << "(bso/structural_design/topology_optimization/optimization_driver.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		mFEA->setDisplacements(mRealizationDisplacements[realization]);
+	} // applyRealization()
+
+	const element::element_batch& optimization_driver::computeEnergies(const unsigned int& batch,
+		const Eigen::VectorXd& densities, const double& penal)
+	{
+		if (batch >= mBatches.size() || !mBatchesBuilt)
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot compute the energies of energy batch: " << batch << "\n"
+									 << "the batch does not exist or the FEA system has not been solved yet.\n"
+									 << "(bso/structural_design/topology_optimization/optimization_driver.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		mBatches[batch].compute(mFEA->getDisplacements(), densities, penal);
+		return mBatches[batch];
+	} // computeEnergies()
+
+	const element::element_batch& optimization_driver::computeEnergies(const unsigned int& batch,
+		const Eigen::VectorXd& densities, const double& penal, const unsigned int& realization)
+	{
+		if (batch >= mBatches.size() || !mBatchesBuilt || realization >= mRealizationDisplacements.size())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot compute the energies of energy batch: " << batch << "\n"
+									 << "for realization: " << realization << "\n"
+									 << "the batch or realization does not exist or has not been solved yet.\n"
+									 << "(bso/structural_design/topology_optimization/optimization_driver.cpp)" << std::endl;
+			throw std::runtime_error(errorMessage.str());
+		}
+		mBatches[batch].compute(mRealizationDisplacements[realization], densities, penal);
+		return mBatches[batch];
+	} // computeEnergies()
+
+	void optimization_driver::setColumns(const std::vector<std::pair<std::string, unsigned int> >& columns,
+		const unsigned int& headerInterval /*= 20*/)
+	{
+		mColumns = columns;
+		mHeaderInterval = headerInterval;
+	} // setColumns()
+
+	void optimization_driver::printHeader()
+	{
+		mOut << std::endl;
+		for (const auto& i : mColumns) mOut << std::setw(i.second) << std::left << i.first;
+		mOut << std::endl;
+	} // printHeader()
+
+	void optimization_driver::startIteration()
+	{
+		mIterationStart = clock_type::now();
+		if (mHeaderInterval > 0 && mIteration%mHeaderInterval == 0) this->printHeader();
+		++mIteration;
+	} // startIteration()
+
+	void optimization_driver::logIteration(const std::vector<double>& values)
+	{
+		if (values.size() + 1 != mColumns.size())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot log " << values.size() << " values in a table of "
+									 << mColumns.size() << " columns.\n"
+									 << "(bso/structural_design/topology_optimization/optimization_driver.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+		for (unsigned int i = 0; i < values.size(); ++i)
+		{
+			mOut << std::setw(mColumns[i].second) << std::left << values[i];
+		}
+		std::chrono::duration<double> iterationTime = clock_type::now() - mIterationStart;
+		mOut << std::setw(mColumns.back().second) << std::left << iterationTime.count() << std::endl;
+	} // logIteration()
+
+	void optimization_driver::finish()
+	{
+		std::chrono::duration<double> totalTime = clock_type::now() - mStart;
+		mOut << "Topology optimisation successfully finished after: "
+				 << totalTime.count() << " seconds."
+				 << std::endl << std::endl;
+	} // finish()
+
+	template <class FUNCTION>
+	double optimization_driver::timed(FUNCTION f)
+	{
+		clock_type::time_point start = clock_type::now();
+		f();
+		std::chrono::duration<double> time = clock_type::now() - start;
+		return time.count();
+	} // timed()
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_TOPOPT_OPTIMIZATION_DRIVER_CPP
@@ -0,0 +1,91 @@
+#ifndef SD_TOPOPT_OPTIMIZATION_DRIVER_HPP
+#define SD_TOPOPT_OPTIMIZATION_DRIVER_HPP
+
+#include <bso/structural_design/fea.hpp>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	/*
+	 * Common part of the topology optimization methods. The driver:
+	 * - solves the FEA system in each iteration, or several realizations of the
+ *   densities (e.g. the eroded, nominal and dilated designs) concurrently
+	 * - evaluates the element energies and sensitivities with batches that are
+	 *   built on the first solve
+	 * - builds the density filters with the thread count of the FEA system
+	 * - writes the table of iterations with the wall time of each iteration
+	 * The methods combine it with the update schemes in update_schemes.hpp.
+	 */
+
+	class optimization_driver
+	{
+	private:
+		typedef std::chrono::steady_clock clock_type;
+
+		fea* mFEA;
+		std::ostream mOut;
+		std::string mSolver;
+
+		std::vector<std::vector<element::element*> > mBatchElements;
+		std::vector<element::element_batch> mBatches;
+		bool mBatchesBuilt = false;
+		std::vector<Eigen::MatrixXd> mRealizationDisplacements;
+
+		void buildBatches(); // the element freedom tables are generated with the first GSM
+
+		std::vector<std::pair<std::string, unsigned int> > mColumns; // header and width of the columns of the table
+		unsigned int mHeaderInterval = 0; // 0: the header is only printed by printHeader()
+		unsigned int mIteration = 0;
+		clock_type::time_point mStart, mIterationStart;
+	public:
+		optimization_driver(fea* FEA, std::streambuf* out, const std::string& solver = "SimplicialLDLT");
+		~optimization_driver();
+
+		unsigned int getThreadCount() const; // the thread count of the FEA system, 1 if it is not parallel
+		void buildFilter(const std::vector<element::element*>& elements, const double& rMin,
+			Eigen::SparseMatrix<double>& H, Eigen::VectorXd& Hs) const;
+		void buildFilters(const std::vector<std::vector<element::element*> >& groups, const double& rMin,
+			std::vector<Eigen::SparseMatrix<double> >& H, std::vector<Eigen::VectorXd>& Hs) const; // one filter per group
+
+		unsigned int addEnergyBatch(const std::vector<element::element*>& elements); // returns the index of the batch
+		void solve(); // assembles and solves the FEA system
+		// solves the displacements of each realization of the (modified SIMP) densities
+		// of the elements, indexed as fea::getElements(), without changing the elements
+		void solveRealizations(const std::vector<Eigen::VectorXd>& densities, const double& penal);
+		void applyRealization(const unsigned int& realization); // its displacements become the response of the FEA system
+		const element::element_batch& computeEnergies(const unsigned int& batch,
+			const Eigen::VectorXd& densities, const double& penal);
+		const element::element_batch& computeEnergies(const unsigned int& batch,
+			const Eigen::VectorXd& densities, const double& penal, const unsigned int& realization);
+
+		// the last column is the wall time of the iteration
+		void setColumns(const std::vector<std::pair<std::string, unsigned int> >& columns,
+			const unsigned int& headerInterval = 20);
+		void printHeader();
+		void startIteration(); // also prints the header every headerInterval iterations
+		void logIteration(const std::vector<double>& values); // one value for each column but the last
+		void finish();
+
+		template <class FUNCTION>
+		static double timed(FUNCTION f); // wall time of calling f() in seconds
+
+		std::ostream& out() {return mOut;}
+		const unsigned int& iteration() const {return mIteration;}
+		fea* getFEA() {return mFEA;}
+	};
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/topology_optimization/optimization_driver.cpp>
+
+#endif // SD_TOPOPT_OPTIMIZATION_DRIVER_HPP
@@ -8,7 +8,6 @@
 #include <map>
 #include <algorithm>
 #include <cstdlib>
-#include <ctime>
 #include <cmath>
 
 namespace bso { namespace structural_design { namespace topology_optimization {
@@ -17,35 +16,50 @@ class ROBUST;
 
 } // namespace topology_optimization
 
-double densityProjection(double beta, double eta, double x)
-{
-	return (tanh(beta * eta) + tanh(beta * (x - eta))) /
-				 (tanh(beta * eta) + tanh(beta * (1 - eta)));
-}
-
 template <>
-void sd_model::topologyOptimization<topology_optimization::ROBUST>(const double& f, 
+void sd_model::topologyOptimization<topology_optimization::ROBUST>(const double& f,
 						const double& rMin, const double& penal, const double& xMove,
 						const double& tolerance)
 {
-	std::ostream out(mTopOptStreamBuffer);
+	topology_optimization::optimization_driver driver(mFEA, mTopOptStreamBuffer, mTopOptSolver);
 	unsigned int numEle = mFEA->getElements().size();
 	double Mnd;
 	double beta = 1.0;
-	double etae = 0.8;
-	double etan = 0.5;
+	topology_optimization::heaviside_projection eroded(beta, 0.8), nominal(beta, 0.5), dilated(beta, 0.2);
 	double totVolume = 0; // initialised at 0, before each element volumes are added
-	double c; // sum of all the elements compliances (objective value)
-
-	Eigen::VectorXd xe(numEle), xn(numEle), x(numEle), xTilde(numEle), xNew(numEle),
-									xChange(numEle), volume(numEle), dc(numEle), dv(numEle); // initialise containers for element values
+	double c; // compliance of the worst realization (objective value)
+
+	Eigen::VectorXd x(numEle), xTilde(numEle), xNew(numEle), xChange(numEle), volume(numEle),
+									dc(numEle), dv(numEle), xSolved(numEle); // initialise containers for element values
+
+	// the realizations of which the FEA system is solved. By default only the eroded design:
+	// it has the least material, so with fixed loads its compliance bounds the others. The
+	// min-max formulation (sd_model::setRobustMinMax()) also solves the nominal and dilated
+	// designs and minimizes the largest compliance, for problems where that ordering does not
+	// hold (e.g. self-weight), at the cost of three solves per iteration. The designs are
+	// projected together, in one pass over xTilde
+	std::vector<Eigen::VectorXd> realizations(mRobustMinMax ? 3 : 1),
+		realizationDerivatives(realizations.size());
+	Eigen::VectorXd nominalDesign, nominalDerivative;
+	Eigen::VectorXd& xn = mRobustMinMax ? realizations[1] : nominalDesign;
+	Eigen::VectorXd& dxn = mRobustMinMax ? realizationDerivatives[1] : nominalDerivative;
+	std::vector<double> etas = {eroded.getEta(), nominal.getEta()};
+	std::vector<Eigen::VectorXd*> projections = {&realizations[0], &xn};
+	std::vector<Eigen::VectorXd*> derivatives = {&realizationDerivatives[0], &dxn};
+	if (mRobustMinMax)
+	{
+		etas.push_back(dilated.getEta());
+		projections.push_back(&realizations[2]);
+		derivatives.push_back(&realizationDerivatives[2]);
+	}
+	const std::vector<Eigen::VectorXd*> noDerivatives(etas.size(), nullptr);
+	Eigen::VectorXd realizationCompliances(realizations.size());
+	unsigned int worst = 0; // the realization with the largest compliance
 
 	// prepare filter
 	Eigen::SparseMatrix<double> H(numEle, numEle); // contains filter vectors for each element
 	Eigen::VectorXd Hs; // contains sums of filter vectors of each element
-	Hs.setZero(numEle); // initialise to size and all zeros
-	typedef Eigen::Triplet<double> T;
-	std::vector<T> tripletList;
+	driver.buildFilter(mFEA->getElements(), rMin, H, Hs);
 
 	unsigned int eleIndexI = 0;
 	for (auto& i : mFEA->getElements())
@@ -53,178 +67,111 @@ void sd_model::topologyOptimization<topology_optimization::ROBUST>(const double&
 		volume(eleIndexI) = i->getVolume();
 		x(eleIndexI) = f;
 		i->updateDensity(f,penal);
-		
-		unsigned int eleIndexJ = 0;
-		for (auto& j : mFEA->getElements())
-		{ // and for each element j
-			// calculate distance center to center distance r_ij between element i and j
-			bso::utilities::geometry::line_segment lij = 
-				{i->getCenter(), j->getCenter()};
-			double rij = lij.getLength();
-
-			if (rij < rMin)
-			{
-				tripletList.push_back(T(eleIndexI, eleIndexJ, (rMin - rij)));
-				Hs(eleIndexI) += rMin - rij;
-			}
-			++eleIndexJ;
-		}
 		++eleIndexI;
 	}
-	H.setFromTriplets(tripletList.begin(), tripletList.end());
 	totVolume = volume.sum();
-	tripletList.clear();
 	xTilde = x;
-	
-	eleIndexI = 0;
-	for (auto& i : mFEA->getElements())
-	{ // for each element i
-		xn(eleIndexI) = densityProjection(beta,etan,xTilde(eleIndexI));
-		xe(eleIndexI) = densityProjection(beta,etae,xTilde(eleIndexI));
-		++eleIndexI;
-	}
-	
-	out << "Total Volume: " << totVolume << std::endl;
+	for (auto& i : realizations) i = x; // the first iteration solves the initial densities
+	unsigned int energyBatch = driver.addEnergyBatch(mFEA->getElements());
+
+	driver.out() << "Total Volume: " << totVolume << std::endl;
 
 	// initialise iteration
 	double change = 1;
 	double xMoveBeta = (xMove*tanh(0.5*beta))/(0.5*beta);
-	int loop = 0;
+	topology_optimization::optimality_criteria OC(xMoveBeta, 1e-50, 1e50);
 	int loopBeta = 0;
 
-	double loopStart = clock(), iterationStart, timeEnd = 0.0;
-	out << std::endl
-			<< std::setw(5)  << std::left << "loop"
-			<< std::setw(10) << std::left << "loop_beta"
-			<< std::setw(15) << std::left << "Objective"
-			<< std::setw(15) << std::left << "Volume"
-			<< std::setw(10)  << std::left << "Change"
-			<< std::setw(10)  << std::left << "Mnd"
-			<< std::setw(10)  << std::left << "Time" << std::endl;
+	driver.setColumns({{"loop",5},{"loop_beta",10},{"Objective",15},{"Volume",15},
+										 {"Change",10},{"Mnd",10},{"Time",10}}, 0);
+	driver.printHeader();
 
 	// start iteration
 	while (change > tolerance)
 	{
-			iterationStart = clock();
-
-			++loop;
+			driver.startIteration();
 			++loopBeta;
-			c = 0;
 
-			// FEA
-			mFEA->generateGSM();
-			mFEA->solve("SimplicialLDLT");
+			// FEA of each realization
+			driver.solveRealizations(realizations, penal);
 
-			// objective function and sensitivity analysis (retrieve data from FEA)
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				c 						+= i->getTotalEnergy();
-				dc(eleIndexI) =  i->getEnergySensitivity(penal); 
-				dv(eleIndexI) =  i->getVolume();
-				++eleIndexI;
-			}
-			
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
+			// objective function and sensitivity analysis (retrieve data from FEA),
+			// the objective is the compliance of the worst realization
+			for (unsigned int i = 0; i < realizations.size(); ++i)
 			{
-				dc(eleIndexI) *= ((beta*pow(1/cosh(beta*(xTilde(eleIndexI)-etae)),2))/(tanh(beta*etae)+tanh(beta*(1-etae)))) / Hs(eleIndexI);
-        dv(eleIndexI) *= ((beta*pow(1/cosh(beta*(xTilde(eleIndexI)-etan)),2))/(tanh(beta*etan)+tanh(beta*(1-etan)))) / Hs(eleIndexI);
-				++eleIndexI;
+				const auto& energies = driver.computeEnergies(energyBatch, realizations[i], penal, i);
+				realizationCompliances(i) = energies.getTotalEnergy();
+				if (i == 0 || realizationCompliances(i) > realizationCompliances(worst))
+				{
+					worst = i;
+					dc = energies.getEnergySensitivities();
+				}
 			}
+			c = realizationCompliances(worst);
+			xSolved = realizations[worst];
 
+			// chain rule of the projections and the density filter
+			topology_optimization::heaviside_project(xTilde, beta, etas, projections, derivatives);
+			dc.array() *= realizationDerivatives[worst].array() / Hs.array();
+			dv.array() = volume.array() * dxn.array() / Hs.array();
 			dc = H * dc;
 			dv = H * dv;
-			
+
 			// optimality criteria update of design variables and physical densities
-			double l1 = 1e-50, l2 = 1e50, lmid, upper, lower;
-			while (((l2-l1)/(l1+l2))>1e-3)
+			OC.update(x, xNew, dc, dv, f * totVolume, [&](const Eigen::VectorXd& xDesign)
 			{
-				lmid = (l1+l2)/2.0;
-
-				for (unsigned int i = 0; i < numEle; i++)
-				{
-					xNew(i) = x(i) * (std::sqrt(-dc(i)/(lmid*dv(i))));
-					upper = std::min(1.0, (x(i) + xMoveBeta));
-					lower = std::max(0.0, (x(i) - xMoveBeta));
-
-					if (xNew(i) > upper)
-					{
-						xNew(i) = upper;
-					}
-					else if (xNew(i) < lower)
-					{
-						xNew(i) = lower;
-					}
-				}
-				
 				// filter the new densities
-				xTilde = H * xNew;
-
-				eleIndexI = 0;
-				for (auto& i : mFEA->getElements())
-				{// for each element
-					// finish filtering
-					xTilde(eleIndexI) /= Hs(eleIndexI);
-					// calculate nominal and erode densities
-					xn(eleIndexI) = densityProjection(beta, etan, xTilde(eleIndexI));
-					xe(eleIndexI) = densityProjection(beta, etae, xTilde(eleIndexI));
-					++eleIndexI;
-				}
-				((volume * xn.transpose()).trace() > f * totVolume) ? l1 = lmid : l2 = lmid;
-			}
-		
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				i->updateDensity(xe(eleIndexI), penal);
-				++eleIndexI;
-			}
-			
+				xTilde.noalias() = H * xDesign;
+				xTilde.array() /= Hs.array();
+
+				// calculate the densities of the realizations
+				topology_optimization::heaviside_project(xTilde, beta, etas, projections, noDerivatives);
+				return volume.dot(xn);
+			});
+
 			// update change
 			xChange = xNew - x;
 			change = xChange.cwiseAbs().maxCoeff();
-			
+
 			x = xNew;
 
-			Mnd = 0.0;
-			eleIndexI = 0;
-			for (auto& i : mFEA->getElements())
-			{
-				Mnd += xn(eleIndexI)*(1.0-xn(eleIndexI));
-				++eleIndexI;
-			}
+			Mnd = (xn.array()*(1.0 - xn.array())).sum();
 			Mnd *= ((1.0/(f*(1.0-f)))*(100.0/numEle));
 
-			timeEnd = clock();
-			out << std::setw(5)  << std::left << loop
-					<< std::setw(10) << std::left << loopBeta
-					<< std::setw(15) << std::left << c
-					<< std::setw(15) << std::left << (volume * xNew.transpose()).trace()
-					<< std::setw(10) << std::left << change
-					<< std::setw(10) << std::left << Mnd
-					<< std::setw(10) << std::left << (timeEnd - iterationStart)/CLOCKS_PER_SEC << std::endl;
+			driver.logIteration({(double)driver.iteration(), (double)loopBeta, c, volume.dot(xNew), change, Mnd});
+
 			// update beta
 			if ((beta < 256) && ((loopBeta >= 50) || (beta < 256 && change <= tolerance)))
 			{
 				beta *= 2;
+				eroded.setBeta(beta);
+				nominal.setBeta(beta);
+				dilated.setBeta(beta);
 				loopBeta = 0;
 				change = 1;
 				xMoveBeta = (xMove*tanh(0.5*beta))/(0.5 * beta);
-				out << "beta increased to: " << beta << std::endl << std::endl;
-				out << std::setw(5)  << std::left << "loop"
-						<< std::setw(10) << std::left << "loop_beta"
-						<< std::setw(15) << std::left << "Objective"
-						<< std::setw(15) << std::left << "Volume"
-						<< std::setw(10) << std::left << "Change"
-						<< std::setw(10) << std::left << "Mnd"
-						<< std::setw(10) << std::left << "Time" << std::endl;
+				OC.setMove(xMoveBeta);
+				driver.out() << "beta increased to: " << beta << std::endl;
+				driver.printHeader();
 			}
 	} // end of iteration
-	out << "Topology optimisation successfully finished after: "
-			<< (timeEnd - loopStart)/CLOCKS_PER_SEC << " seconds."
-			<< std::endl << std::endl;
-	
+
+	if (driver.iteration() > 0)
+	{ // the elements get the response of the last solved (worst) realization
+		eleIndexI = 0;
+		for (auto& i : mFEA->getElements())
+		{
+			i->updateDensity(xSolved(eleIndexI), penal);
+			++eleIndexI;
+		}
+		driver.applyRealization(worst);
+	}
+	else
+	{ // without iterations, the nominal design follows from the initial densities
+		topology_optimization::heaviside_project(xTilde, beta, etas, projections, noDerivatives);
+	}
+	driver.finish();
+
 	eleIndexI = 0;
 	for (auto& i : mFEA->getElements())
 	{
@@ -232,8 +179,8 @@ void sd_model::topologyOptimization<topology_optimization::ROBUST>(const double&
 		++eleIndexI;
 	}
 }
-	
+
 } // namespace structural_design
 } // bso
 
-#endif // SD_TOPOPT_ROBUST_CPP
\ No newline at end of file
+#endif // SD_TOPOPT_ROBUST_CPP
@@ -0,0 +1,116 @@
+#ifndef SD_TOPOPT_STRESS_AGGREGATION_CPP
+#define SD_TOPOPT_STRESS_AGGREGATION_CPP
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	stress_aggregation::stress_aggregation(const aggregation_type& type /*= P_NORM*/,
+		const double& parameter /*= 8.0*/, const unsigned int& clusterCount /*= 10*/,
+		const bool& adaptiveNormalization /*= false*/)
+	: mType(type), mParameter(parameter), mClusterCount(clusterCount),
+		mAdaptiveNormalization(adaptiveNormalization)
+	{
+		if (!(parameter > 0) || clusterCount == 0 || (type == P_NORM && parameter < 1))
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot aggregate stresses with parameter: " << parameter
+									 << " and " << clusterCount << " clusters.\n"
+									 << "(bso/structural_design/topology_optimization/stress_aggregation.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+	} // ctor()
+
+	stress_aggregation::~stress_aggregation()
+	{
+
+	} // dtor()
+
+	unsigned int stress_aggregation::getClusterCount(const unsigned long& elementCount) const
+	{
+		return std::max(1ul, std::min((unsigned long)mClusterCount, elementCount));
+	} // getClusterCount()
+
+	void stress_aggregation::compute(const Eigen::VectorXd& stresses)
+	{
+		unsigned long numEle = stresses.size();
+		unsigned int clusterCount = this->getClusterCount(numEle);
+
+		// stress-level clustering: the elements in descending order of stress
+		std::vector<unsigned long> order(numEle);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&stresses](const unsigned long& a,
+			const unsigned long& b) {return stresses(a) > stresses(b);});
+
+		mClusters.assign(clusterCount, std::vector<unsigned long>());
+		for (unsigned int k = 0; k < clusterCount; ++k)
+		{
+			mClusters[k].assign(order.begin() + (k*numEle)/clusterCount,
+				order.begin() + ((k+1)*numEle)/clusterCount);
+		}
+
+		mValues.setZero(clusterCount);
+		std::vector<Eigen::Triplet<double> > tripletList;
+		tripletList.reserve(numEle);
+		for (unsigned int k = 0; k < clusterCount; ++k)
+		{
+			const std::vector<unsigned long>& cluster = mClusters[k];
+			if (cluster.empty()) continue;
+			double maxStress = stresses(cluster.front()); // clusters are in descending order of stress
+
+			if (mType == P_NORM)
+			{ // (sum(max(s,0)^p))^(1/p), scaled by the largest stress to prevent overflow
+				if (!(maxStress > 0)) continue;
+				double sum = 0;
+				for (const auto& e : cluster)
+				{
+					if (stresses(e) > 0) sum += std::pow(stresses(e)/maxStress, mParameter);
+				}
+				mValues(k) = maxStress * std::pow(sum, 1.0/mParameter);
+				for (const auto& e : cluster)
+				{
+					if (stresses(e) > 0)
+					{
+						tripletList.push_back(Eigen::Triplet<double>(k, e,
+							std::pow(stresses(e)/mValues(k), mParameter - 1)));
+					}
+				}
+			}
+			else
+			{ // max(s) + ln(sum(exp(rho*(s-max(s)))))/rho
+				double sum = 0;
+				for (const auto& e : cluster) sum += std::exp(mParameter*(stresses(e) - maxStress));
+				mValues(k) = maxStress + std::log(sum)/mParameter;
+				for (const auto& e : cluster)
+				{
+					tripletList.push_back(Eigen::Triplet<double>(k, e,
+						std::exp(mParameter*(stresses(e) - maxStress))/sum));
+				}
+			}
+		}
+		mWeights.resize(clusterCount, numEle);
+		mWeights.setFromTriplets(tripletList.begin(), tripletList.end());
+
+		if (mAdaptiveNormalization)
+		{
+			if (mNormalization.size() != clusterCount) mNormalization.setOnes(clusterCount);
+			mValues = mValues.cwiseProduct(mNormalization);
+			mWeights = mNormalization.asDiagonal() * mWeights;
+			for (unsigned int k = 0; k < clusterCount; ++k)
+			{ // ratio of the largest stress measure to the unscaled aggregate, for the next call
+				double value = mValues(k) / mNormalization(k);
+				double maxStress = stresses(mClusters[k].front());
+				if (value > 0 && maxStress > 0) mNormalization(k) = maxStress / value;
+			}
+		}
+	} // compute()
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_TOPOPT_STRESS_AGGREGATION_CPP
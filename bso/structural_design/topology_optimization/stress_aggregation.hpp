@@ -0,0 +1,62 @@
+#ifndef SD_TOPOPT_STRESS_AGGREGATION_HPP
+#define SD_TOPOPT_STRESS_AGGREGATION_HPP
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	/*
+	 * Aggregates the stress measures of the elements into a few constraints.
+	 * The elements are sorted on their stress measure and divided into
+	 * clusters of (almost) equal size (stress-level clustering), the stress
+	 * measures in each cluster are aggregated with a p-norm or with the
+	 * Kreisselmeier-Steinhauser (KS) function. Without normalization both are
+	 * upper bounds of the largest stress measure in the cluster (the p-norm
+	 * ignores negative values).
+	 * The weights are the derivatives of the aggregates with respect to the
+	 * stress measures, with one nonzero for each element.
+	 * With adaptive normalization the aggregates of each call are scaled by
+	 * the ratio of the largest stress measure to the aggregate in the previous
+	 * call (Le et al., 2010), so that they approach the largest stress measure.
+	 */
+
+	class stress_aggregation
+	{
+	public:
+		enum aggregation_type {P_NORM, KS};
+	private:
+		aggregation_type mType;
+		double mParameter; // p of the p-norm or rho of the KS function
+		unsigned int mClusterCount;
+		bool mAdaptiveNormalization;
+		Eigen::VectorXd mNormalization; // scale factor of each cluster, from the previous call
+
+		std::vector<std::vector<unsigned long> > mClusters; // element indices of each cluster
+		Eigen::VectorXd mValues; // aggregate of each cluster
+		Eigen::SparseMatrix<double, Eigen::RowMajor> mWeights; // d(aggregate_k)/d(stress_e)
+	public:
+		stress_aggregation(const aggregation_type& type = P_NORM, const double& parameter = 8.0,
+			const unsigned int& clusterCount = 10, const bool& adaptiveNormalization = false);
+		~stress_aggregation();
+
+		void compute(const Eigen::VectorXd& stresses); // clusters and aggregates the stress measures
+
+		unsigned int getClusterCount(const unsigned long& elementCount) const; // at most one cluster per element
+		const std::vector<std::vector<unsigned long> >& getClusters() const {return mClusters;}
+		const Eigen::VectorXd& getValues() const {return mValues;}
+		const Eigen::VectorXd& getNormalization() const {return mNormalization;}
+		const Eigen::SparseMatrix<double, Eigen::RowMajor>& getWeights() const {return mWeights;}
+		const aggregation_type& getType() const {return mType;}
+		const double& getParameter() const {return mParameter;}
+	};
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/topology_optimization/stress_aggregation.cpp>
+
+#endif // SD_TOPOPT_STRESS_AGGREGATION_HPP
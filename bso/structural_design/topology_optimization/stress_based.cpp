@@ -8,9 +8,6 @@
 #include <map>
 #include <algorithm>
 #include <cstdlib>
-#include <ctime>
-
-#include <bso/structural_design/topology_optimization/MMA.hpp>
 
 namespace bso { namespace structural_design { namespace topology_optimization {
 
@@ -21,10 +18,13 @@ class STRESS_BASED;
 template <>
 void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 					const double& volinit, const double& rMin, const double& penal,
-					const double& xMin, const double& TStrength, const double& CStrength, const double& tolerance, const double& move)
+					const double& xMin, const double& TStrength, const double& CStrength, const double& tolerance, const double& move,
+					const topology_optimization::stress_aggregation& aggregationSettings)
 {
-	std::ostream out(mTopOptStreamBuffer);
+	topology_optimization::optimization_driver driver(mFEA, mTopOptStreamBuffer, mTopOptSolver);
+	topology_optimization::stress_aggregation aggregation = aggregationSettings;
 	unsigned int numEle = mFEA->getElements().size();
+	unsigned int numCon = aggregation.getClusterCount(numEle); // one aggregated stress constraint per cluster
 	double totVolume = 0; // initialised at 0, before each element volumes are added
 	double c; // sum of all the elements compliances
 	double eps = sqrt(xMin);
@@ -33,16 +33,15 @@ void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 
 	Eigen::VectorXd x(numEle), xPhys(numEle), xNew(numEle), xChange(numEle),
 					volume(numEle), s(numEle), dv(numEle); // initialise containers for element values
-	Eigen::MatrixXd ds(numEle,numEle); // initialise container for stress sensitivity matrix
+	Eigen::VectorXd g(numCon); // aggregated stress constraints
+	Eigen::MatrixXd dg(numCon,numEle); // initialise container for the sensitivities of the aggregated stress constraints
 	Eigen::VectorXd vf;
 	vf.setOnes(10); // initialize vector with last 10 volume-fraction values for convergence criterion
 
 	// prepare filter
 	Eigen::SparseMatrix<double> H(numEle, numEle); // contains filter vectors for each element
 	Eigen::VectorXd Hs; // contains sums of filter vectors of each element
-	Hs.setZero(numEle); // initialise to size and all zeros
-	typedef Eigen::Triplet<double> T;
-	std::vector<T> tripletList;
+	driver.buildFilter(mFEA->getElements(), rMin, H, Hs);
 
 	unsigned int eleIndexI = 0;
 	for (auto& i : mFEA->getElements())
@@ -50,73 +49,33 @@ void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 		volume(eleIndexI) = i->getVolume();
 		x(eleIndexI) = volinit;
 		i->updateDensity(volinit,penal,"regularSIMP");
-
-		unsigned int eleIndexJ = 0;
-		for (auto& j : mFEA->getElements())
-		{ // and for each element j
-			// calculate distance center to center distance r_ij between element i and j
-			bso::utilities::geometry::line_segment lij =
-				{i->getCenter(), j->getCenter()};
-			double rij = lij.getLength();
-
-			if (rij < rMin)
-			{
-				tripletList.push_back(T(eleIndexI, eleIndexJ, (rMin - rij)));
-				Hs(eleIndexI) += rMin - rij;
-			}
-			++eleIndexJ;
-		}
 		++eleIndexI;
 	}
-	H.setFromTriplets(tripletList.begin(), tripletList.end());
 	totVolume = volume.sum();
-	tripletList.clear();
-	out << "Total Volume: " << totVolume << std::endl;
+	driver.out() << "Total Volume: " << totVolume << std::endl;
 
 	// initialise iteration
 	xPhys = x;
 	const unsigned long freeDOFs = mFEA->getDOFCount();
-	double change = 1.0;
 	double changevol = 1.0;
-	int loop = 0;
-	double loopStart = clock(), iterationStart, startMMA, endMMA, timeEnd = 0.0;
+	double timeMMA = 0.0;
 
-	// define MMA parameters
-	const int n = numEle;	// nr of variables
-	const int m = numEle;	// nr of constraints
-	Eigen::VectorXd xmin(n), xmax(n), xold1(n), xold2(n), low(n), upp(n);
+	// define MMA parameters, one constraint per cluster of elements
+	Eigen::VectorXd xmin(numEle), xmax(numEle);
 	xmin.setConstant(xMin);
 	xmax.setOnes();
-	xold1 = x;
-	xold2 = xold1;
-	low = xmin;
-	upp = xmax;
-	const double a0 = 1.0;
-	Eigen::VectorXd amma(m), cmma(m), dmma(m);
-	amma.setZero();
-	cmma.setConstant(1000);
-	dmma.setZero();
+	topology_optimization::mma_update MMA(x, xmin, xmax, numCon, move);
+
+	driver.setColumns({{"Loop",5},{"Compliance",13},{"Volfrac.",13},{"Changevol.",13},
+										 {"Stress",13},{"Aggregate",13},{"TimeMMA",10},{"Time",10}});
 
 	// start iteration
 	while (changevol > tolerance || s.maxCoeff() > 1e-5)
 	{
-			iterationStart = clock();
-			if (loop%20 == 0)
-			{
-					out << std::endl
-							<< std::setw(5)  << std::left << "Loop"
-							<< std::setw(13) << std::left << "Compliance"
-							<< std::setw(13) << std::left << "Volfrac."
-							<< std::setw(13) << std::left << "Changevol."
-							<< std::setw(13) << std::left << "Stress"
-							<< std::setw(10) << std::left << "TimeMMA"
-							<< std::setw(10) << std::left << "Time" << std::endl;
-			}
-
-			++loop;
-			c = 0;
+			driver.startIteration();
+			const int loop = driver.iteration();
 
-			double volfrac = (volume * xPhys.transpose()).trace() / totVolume;
+			double volfrac = volume.dot(xPhys) / totVolume;
 			if (loop < 11) {vf(loop-1) = volfrac;}
 			else
 			{
@@ -129,46 +88,69 @@ void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 			}
 
 			// FEA
-			mFEA->generateGSM();
-			mFEA->solve("SimplicialLDLT");
+			driver.solve();
+			c = mFEA->getElementResults().mTotalEnergy.sum();
 
-			Eigen::MatrixXd ae;
-			ae.setZero(freeDOFs,numEle); // adjoint load vectors for stress sensitivity calculation
-
-			// objective function and sensitivity analysis (retrieve data from FEA)
+			// objective function and relaxed stresses (retrieve data from FEA)
 			eleIndexI = 0;
 			for (auto& i : mFEA->getElements())
 			{
-				c 						+= i->getTotalEnergy();
-				dv(eleIndexI) =  i->getVolume();
-				dv(eleIndexI) /= totVolume;
+				dv(eleIndexI) =  volume(eleIndexI) / totVolume;
 				s(eleIndexI)  =  i->getStressAtCenter(alpha, beta); // gives Drucker-Prager stress for unequal strength limits, and Von Mises stress for equal strength limits
 				s(eleIndexI) +=  eps - 1 - eps / xPhys(eleIndexI); // relaxed stress, should be < 0
-				ae.col(eleIndexI) = i->getStressSensitivityTermAE(freeDOFs, alpha); // adjoint load vectors are required for the stress sensitivity calculation
 				++eleIndexI;
 			}
 
-			Eigen::MatrixXd Lambda = mFEA->solveAdjoint(ae); // solve equilibrium equations with adjoint load vectors [K*Lambda(e) = a(e)]
+			// aggregate the relaxed stresses (+1) per cluster, the constraints are: aggregate - 1 < 0
+			aggregation.compute(s.array() + 1.0);
+			const Eigen::SparseMatrix<double, Eigen::RowMajor>& weights = aggregation.getWeights();
+			g = aggregation.getValues().array() - 1.0;
 
-			// stress sensitivity calculation
+			// adjoint load vectors: the weighted sum of the element terms of each cluster, each element
+			// term has as many nonzeros as the element has free DOFs
+			std::vector<Eigen::Triplet<double> > aeTriplets;
+			Eigen::SparseMatrix<double> elementWeights = weights; // column major: the clusters of each element
 			eleIndexI = 0;
 			for (auto& i : mFEA->getElements())
 			{
-				ds.col(eleIndexI) = i->getStressSensitivity(Lambda, penal, beta);
-				ds(eleIndexI,eleIndexI) += eps / pow(xPhys(eleIndexI),2); // add relaxation term on diagonal
+				if (elementWeights.col(eleIndexI).nonZeros() > 0)
+				{
+					const std::vector<long>& EFT = i->getEFT();
+					Eigen::VectorXd aeI = i->getElementStressSensitivityTermAE(alpha);
+					for (Eigen::SparseMatrix<double>::InnerIterator it(elementWeights,eleIndexI); it; ++it)
+					{
+						for (unsigned int j = 0; j < EFT.size(); ++j)
+						{
+							if (EFT[j] >= 0) aeTriplets.push_back(Eigen::Triplet<double>(EFT[j], it.row(), it.value() * aeI(j)));
+						}
+					}
+				}
 				++eleIndexI;
 			}
+			Eigen::SparseMatrix<double> ae(freeDOFs,numCon);
+			ae.setFromTriplets(aeTriplets.begin(), aeTriplets.end());
 
-			// filter stress sensitivity
-			for (unsigned int i = 0; i < numEle; i++)
+			Eigen::MatrixXd Lambda = mFEA->solveAdjoint(ae); // solve equilibrium equations with adjoint load vectors [K*Lambda(k) = a(k)]
+
+			// sensitivity of the aggregated stress constraints
+			eleIndexI = 0;
+			for (auto& i : mFEA->getElements())
 			{
-				for (unsigned int j = 0; j < numEle; j++)
+				dg.col(eleIndexI) = i->getStressSensitivity(Lambda, penal, beta);
+				++eleIndexI;
+			}
+			for (int k = 0; k < weights.outerSize(); ++k)
+			{ // add relaxation term of the elements in each cluster
+				for (Eigen::SparseMatrix<double, Eigen::RowMajor>::InnerIterator it(weights,k); it; ++it)
 				{
-					ds(i,j) /= Hs(j);
+					dg(k,it.col()) += it.value() * eps / pow(xPhys(it.col()),2);
 				}
-				ds.row(i) = ds.row(i) * H.transpose();
 			}
 
+			// filter stress sensitivity
+			dg = dg * Hs.cwiseInverse().asDiagonal();
+			dg = (H * dg.transpose()).transpose();
+
 			// filter volume sensitivity
 			for (unsigned int i = 0; i < numEle; i++)
 			{
@@ -177,22 +159,13 @@ void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 			dv = H * dv;
 
 			// update of design variables and physical densities (MMA solver)
-			startMMA = clock();
-			topology_optimization::MMA MMA;
-			MMA.MMAsub(m,n,loop,x,xmin,xmax,xold1,xold2,volfrac,dv,s,ds,low,upp,a0,amma,cmma,dmma,move);
-			low = MMA.getLow();
-			upp = MMA.getUpp();
-			xNew = MMA.getxNew();
-			xold2 = xold1;
-			xold1 = x;
-			endMMA = clock();
+			timeMMA = driver.timed([&]()
+			{
+				MMA.update(loop, x, xNew, volfrac, dv, g, dg);
+			});
 
 			// density filter
-			xPhys = H * xNew;
-			for (unsigned int i = 0; i < numEle; i++)
-			{
-				xPhys(i) /= Hs(i);
-			}
+			xPhys = (H * xNew).cwiseQuotient(Hs);
 
 			eleIndexI = 0;
 			for (auto& i : mFEA->getElements())
@@ -201,21 +174,21 @@ void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
 				++eleIndexI;
 			}
 
-			timeEnd = clock();
-			out << std::setw(5)  << std::left << loop
-					<< std::setw(13) << std::left << 2*c
-					<< std::setw(13) << std::left << volfrac
-					<< std::setw(13) << std::left << changevol
-					<< std::setw(13) << std::left << s.maxCoeff()
-					<< std::setw(10) << std::left << (endMMA - startMMA)/CLOCKS_PER_SEC
-					<< std::setw(10) << std::left << (timeEnd - iterationStart)/CLOCKS_PER_SEC << std::endl;
+			driver.logIteration({(double)loop, 2*c, volfrac, changevol, s.maxCoeff(), g.maxCoeff(), timeMMA});
 
 			x = xNew;
 
 	} // end of iteration
-	out << "Topology optimisation successfully finished after: "
-			<< (timeEnd - loopStart)/CLOCKS_PER_SEC << " seconds."
-			<< std::endl << std::endl;
+	driver.finish();
+} // topology_optimization::STRESS_BASED
+
+template <>
+void sd_model::topologyOptimization<topology_optimization::STRESS_BASED>(
+					const double& volinit, const double& rMin, const double& penal,
+					const double& xMin, const double& TStrength, const double& CStrength, const double& tolerance, const double& move)
+{ // p-norm aggregation with the default settings
+	this->topologyOptimization<topology_optimization::STRESS_BASED>(volinit, rMin, penal, xMin,
+		TStrength, CStrength, tolerance, move, topology_optimization::stress_aggregation());
 } // topology_optimization::STRESS_BASED
 
 } // namespace structural_design
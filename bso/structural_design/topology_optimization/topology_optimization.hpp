@@ -3,6 +3,11 @@
 
 #include <iomanip>
 
+#include <bso/structural_design/topology_optimization/density_filter.hpp>
+#include <bso/structural_design/topology_optimization/update_schemes.hpp>
+#include <bso/structural_design/topology_optimization/stress_aggregation.hpp>
+#include <bso/structural_design/topology_optimization/optimization_driver.hpp>
+
 #include <bso/structural_design/topology_optimization/SIMP.cpp>
 #include <bso/structural_design/topology_optimization/robust.cpp>
 #include <bso/structural_design/topology_optimization/stress_based.cpp>
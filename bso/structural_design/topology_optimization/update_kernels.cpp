@@ -0,0 +1,81 @@
+#ifndef SD_TOPOPT_UPDATE_KERNELS_CPP
+#define SD_TOPOPT_UPDATE_KERNELS_CPP
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	void oc_move_bounds(const Eigen::VectorXd& x, const double& move,
+		Eigen::VectorXd& lower, Eigen::VectorXd& upper)
+	{
+		lower.resize(x.size());
+		upper.resize(x.size());
+		lower.array() = (x.array() - move).max(0.0);
+		upper.array() = (x.array() + move).min(1.0);
+	} // oc_move_bounds()
+
+	void oc_step(const Eigen::VectorXd& x, const Eigen::VectorXd& dc, const Eigen::VectorXd& dv,
+		const double& lmid, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper,
+		Eigen::VectorXd& xNew)
+	{
+		xNew.resize(x.size());
+		xNew.array() = (x.array() * (-dc.array() / (lmid*dv.array())).sqrt()).min(upper.array()).max(lower.array());
+	} // oc_step()
+
+	void heaviside_project(const Eigen::VectorXd& x, const double& beta, const double& eta,
+		Eigen::VectorXd& projected, Eigen::VectorXd* derivative /*= nullptr*/)
+	{
+		heaviside_project(x, beta, {eta}, {&projected}, {derivative});
+	} // heaviside_project()
+
+	void heaviside_project(const Eigen::VectorXd& x, const double& beta, const std::vector<double>& etas,
+		const std::vector<Eigen::VectorXd*>& projected, const std::vector<Eigen::VectorXd*>& derivatives)
+	{
+		if (projected.size() != etas.size() || derivatives.size() != etas.size())
+		{
+			std::stringstream errorMessage;
+			errorMessage << "\nCannot project for " << etas.size() << " thresholds into "
+									 << projected.size() << " projections and " << derivatives.size() << " derivatives.\n"
+									 << "(bso/structural_design/topology_optimization/update_kernels.cpp)" << std::endl;
+			throw std::invalid_argument(errorMessage.str());
+		}
+
+		const unsigned int designCount = etas.size();
+		std::vector<double> offsets(designCount), scales(designCount);
+		for (unsigned int k = 0; k < designCount; ++k)
+		{
+			offsets[k] = std::tanh(beta * etas[k]);
+			scales[k] = 1.0 / (offsets[k] + std::tanh(beta * (1 - etas[k])));
+			projected[k]->resize(x.size());
+			if (derivatives[k] != nullptr) derivatives[k]->resize(x.size());
+		}
+
+		// blocks that stay in cache while all thresholds are processed
+		const long blockSize = 512;
+		Eigen::ArrayXd t(blockSize);
+		for (long start = 0; start < x.size(); start += blockSize)
+		{
+			const long n = std::min(blockSize, (long)x.size() - start);
+			auto xBlock = x.segment(start, n).array();
+			for (unsigned int k = 0; k < designCount; ++k)
+			{ // with t = exp(-2|z|): tanh(z) = sign(z)(1-t)/(1+t) and sech^2(z) = 4t/(1+t)^2,
+				// sech^2 stays positive for large beta where 1-tanh^2 would cancel to zero
+				t.head(n) = (-2.0 * beta * (xBlock - etas[k]).abs()).exp();
+				projected[k]->segment(start, n).array() = (offsets[k] +
+					(xBlock - etas[k]).sign() * (1.0 - t.head(n)) / (1.0 + t.head(n))) * scales[k];
+				if (derivatives[k] != nullptr)
+				{
+					derivatives[k]->segment(start, n).array() = (4.0 * beta * scales[k]) * t.head(n) / (1.0 + t.head(n)).square();
+				}
+			}
+		}
+	} // heaviside_project()
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_TOPOPT_UPDATE_KERNELS_CPP
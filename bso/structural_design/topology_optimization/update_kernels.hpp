@@ -0,0 +1,40 @@
+#ifndef SD_TOPOPT_UPDATE_KERNELS_HPP
+#define SD_TOPOPT_UPDATE_KERNELS_HPP
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	/*
+	 * Element-wise kernels of the update schemes, written as Eigen array
+	 * expressions that write into the storage of their outputs. Outputs are
+	 * only resized if their size differs from the size of the input, so
+	 * repeated calls (e.g. in a bisection) do not allocate.
+	 */
+
+	// the bounds of the OC update: max(0,x-move) and min(1,x+move)
+	void oc_move_bounds(const Eigen::VectorXd& x, const double& move,
+		Eigen::VectorXd& lower, Eigen::VectorXd& upper);
+	// one step of the OC bisection: xNew = clamp(x*sqrt(-dc/(lmid*dv)), lower, upper)
+	void oc_step(const Eigen::VectorXd& x, const Eigen::VectorXd& dc, const Eigen::VectorXd& dv,
+		const double& lmid, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper,
+		Eigen::VectorXd& xNew);
+
+	// smoothed Heaviside projection with steepness beta and threshold eta,
+	// and optionally its derivative (derivative may be nullptr)
+	void heaviside_project(const Eigen::VectorXd& x, const double& beta, const double& eta,
+		Eigen::VectorXd& projected, Eigen::VectorXd* derivative = nullptr);
+	// the projections of x for several thresholds (e.g. eroded, nominal and dilated)
+	// in one pass: x is read once per block of elements for all thresholds
+	void heaviside_project(const Eigen::VectorXd& x, const double& beta, const std::vector<double>& etas,
+		const std::vector<Eigen::VectorXd*>& projected, const std::vector<Eigen::VectorXd*>& derivatives);
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/topology_optimization/update_kernels.cpp>
+
+#endif // SD_TOPOPT_UPDATE_KERNELS_HPP
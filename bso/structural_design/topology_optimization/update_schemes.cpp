@@ -0,0 +1,107 @@
+#ifndef SD_TOPOPT_UPDATE_SCHEMES_CPP
+#define SD_TOPOPT_UPDATE_SCHEMES_CPP
+
+#include <algorithm>
+#include <cmath>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	optimality_criteria::optimality_criteria(const double& move, const double& l1 /*= 0*/,
+		const double& l2 /*= 1e9*/) : mMove(move), mL1(l1), mL2(l2)
+	{
+
+	} // ctor()
+
+	optimality_criteria::~optimality_criteria()
+	{
+
+	} // dtor()
+
+	template <class PHYSICAL_VOLUME>
+	void optimality_criteria::update(const Eigen::VectorXd& x, Eigen::VectorXd& xNew,
+		const Eigen::VectorXd& dc, const Eigen::VectorXd& dv, const double& volumeLimit,
+		PHYSICAL_VOLUME physicalVolume) const
+	{
+		double l1 = mL1, l2 = mL2, lmid;
+		Eigen::VectorXd lower, upper; // the bisection itself does not allocate
+		oc_move_bounds(x, mMove, lower, upper);
+		xNew.resize(x.size());
+		while (((l2-l1)/(l1+l2)) > mTolerance)
+		{
+			lmid = (l1+l2)/2.0;
+			oc_step(x, dc, dv, lmid, lower, upper, xNew);
+			(physicalVolume(xNew) > volumeLimit) ? l1 = lmid : l2 = lmid;
+		}
+	} // update()
+
+	void optimality_criteria::update(const Eigen::VectorXd& x, Eigen::VectorXd& xNew,
+		const Eigen::VectorXd& dc, const Eigen::VectorXd& dv, const Eigen::VectorXd& volume,
+		const double& volumeLimit) const
+	{ // the physical densities are the design variables
+		this->update(x, xNew, dc, dv, volumeLimit,
+			[&volume](const Eigen::VectorXd& xPhys) {return volume.dot(xPhys);});
+	} // update()
+
+	heaviside_projection::heaviside_projection(const double& beta, const double& eta)
+	: mBeta(beta), mEta(eta)
+	{
+
+	} // ctor()
+
+	heaviside_projection::~heaviside_projection()
+	{
+
+	} // dtor()
+
+	double heaviside_projection::project(const double& x) const
+	{
+		return (tanh(mBeta * mEta) + tanh(mBeta * (x - mEta))) /
+					 (tanh(mBeta * mEta) + tanh(mBeta * (1 - mEta)));
+	} // project()
+
+	double heaviside_projection::derivative(const double& x) const
+	{
+		return (mBeta*pow(1/cosh(mBeta*(x-mEta)),2))/(tanh(mBeta*mEta)+tanh(mBeta*(1-mEta)));
+	} // derivative()
+
+	void heaviside_projection::project(const Eigen::VectorXd& x, Eigen::VectorXd& projected,
+		Eigen::VectorXd* derivative /*= nullptr*/) const
+	{
+		heaviside_project(x, mBeta, mEta, projected, derivative);
+	} // project()
+
+	mma_update::mma_update(const Eigen::VectorXd& x0, const Eigen::VectorXd& xMin,
+		const Eigen::VectorXd& xMax, const int& constraintCount, const double& move /*= 1.0*/,
+		const double& a0 /*= 1.0*/, const double& c /*= 1000*/)
+	: mN(x0.size()), mM(constraintCount), mMove(move), mA0(a0), mXMin(xMin), mXMax(xMax),
+		mXOld1(x0), mXOld2(x0), mLow(xMin), mUpp(xMax)
+	{
+		mA.setZero(mM);
+		mC.setConstant(mM, c);
+		mD.setZero(mM);
+	} // ctor()
+
+	mma_update::~mma_update()
+	{
+
+	} // dtor()
+
+	void mma_update::update(const int& iteration, const Eigen::VectorXd& x, Eigen::VectorXd& xNew,
+		const double& f0, Eigen::VectorXd& df0dx, Eigen::VectorXd& f, Eigen::MatrixXd& dfdx)
+	{
+		Eigen::VectorXd xval = x;
+		MMA mma;
+		mma.MMAsub(mM,mN,iteration,xval,mXMin,mXMax,mXOld1,mXOld2,f0,df0dx,f,dfdx,
+							 mLow,mUpp,mA0,mA,mC,mD,mMove);
+		mLow = mma.getLow();
+		mUpp = mma.getUpp();
+		xNew = mma.getxNew();
+		mXOld2 = mXOld1;
+		mXOld1 = x;
+	} // update()
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#endif // SD_TOPOPT_UPDATE_SCHEMES_CPP
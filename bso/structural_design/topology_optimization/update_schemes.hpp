@@ -0,0 +1,84 @@
+#ifndef SD_TOPOPT_UPDATE_SCHEMES_HPP
+#define SD_TOPOPT_UPDATE_SCHEMES_HPP
+
+#include <Eigen/Dense>
+
+#include <bso/structural_design/topology_optimization/MMA.hpp>
+#include <bso/structural_design/topology_optimization/update_kernels.hpp>
+
+namespace bso { namespace structural_design { namespace topology_optimization {
+
+	/*
+	 * Update schemes of the design variables that are plugged into the
+	 * topology optimization methods: the optimality criteria (OC) update, the
+	 * method of moving asymptotes (MMA), and a smoothed Heaviside projection
+	 * of the filtered densities.
+	 */
+
+	class optimality_criteria
+	{ // bisection on the Lagrange multiplier of the volume constraint
+	private:
+		double mMove;
+		double mL1, mL2; // initial bounds of the Lagrange multiplier
+		double mTolerance = 1e-3; // relative width of the final bisection interval
+	public:
+		optimality_criteria(const double& move, const double& l1 = 0, const double& l2 = 1e9);
+		~optimality_criteria();
+
+		// PHYSICAL_VOLUME: double(const Eigen::VectorXd& xNew), the volume of
+		// the physical densities that follow from the design variables xNew
+		template <class PHYSICAL_VOLUME>
+		void update(const Eigen::VectorXd& x, Eigen::VectorXd& xNew, const Eigen::VectorXd& dc,
+			const Eigen::VectorXd& dv, const double& volumeLimit, PHYSICAL_VOLUME physicalVolume) const;
+		void update(const Eigen::VectorXd& x, Eigen::VectorXd& xNew, const Eigen::VectorXd& dc,
+			const Eigen::VectorXd& dv, const Eigen::VectorXd& volume, const double& volumeLimit) const;
+
+		void setMove(const double& move) {mMove = move;}
+		const double& getMove() const {return mMove;}
+	};
+
+	class heaviside_projection
+	{ // smoothed Heaviside projection with steepness beta and threshold eta
+	private:
+		double mBeta;
+		double mEta;
+	public:
+		heaviside_projection(const double& beta, const double& eta);
+		~heaviside_projection();
+
+		double project(const double& x) const;
+		double derivative(const double& x) const;
+		void project(const Eigen::VectorXd& x, Eigen::VectorXd& projected,
+			Eigen::VectorXd* derivative = nullptr) const; // element-wise, see heaviside_project()
+
+		void setBeta(const double& beta) {mBeta = beta;}
+		const double& getBeta() const {return mBeta;}
+		const double& getEta() const {return mEta;}
+	};
+
+	class mma_update
+	{ // keeps the state of the method of moving asymptotes between iterations
+	private:
+		int mN, mM; // number of variables and constraints
+		double mMove;
+		double mA0;
+		Eigen::VectorXd mXMin, mXMax, mXOld1, mXOld2, mLow, mUpp;
+		Eigen::VectorXd mA, mC, mD;
+	public:
+		mma_update(const Eigen::VectorXd& x0, const Eigen::VectorXd& xMin, const Eigen::VectorXd& xMax,
+			const int& constraintCount, const double& move = 1.0, const double& a0 = 1.0,
+			const double& c = 1000);
+		~mma_update();
+
+		// f0 and df0dx: objective and its gradient, f and dfdx: constraints (<= 0) and their gradients (one column per constraint)
+		void update(const int& iteration, const Eigen::VectorXd& x, Eigen::VectorXd& xNew,
+			const double& f0, Eigen::VectorXd& df0dx, Eigen::VectorXd& f, Eigen::MatrixXd& dfdx);
+	};
+
+} // namespace topology_optimization
+} // namespace structural_design
+} // namespace bso
+
+#include <bso/structural_design/topology_optimization/update_schemes.cpp>
+
+#endif // SD_TOPOPT_UPDATE_SCHEMES_HPP
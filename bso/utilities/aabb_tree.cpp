@@ -0,0 +1,192 @@
+#ifndef BSO_AABB_TREE_CPP
+#define BSO_AABB_TREE_CPP
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace utilities {
+
+namespace aabb_detail {
+	inline bool contains(const Eigen::Vector3d& outerMin, const Eigen::Vector3d& outerMax,
+		const Eigen::Vector3d& innerMin, const Eigen::Vector3d& innerMax)
+	{
+		return (outerMin.array() <= innerMin.array()).all() &&
+					 (innerMax.array() <= outerMax.array()).all();
+	}
+
+	inline bool intersects(const Eigen::Vector3d& min1, const Eigen::Vector3d& max1,
+		const Eigen::Vector3d& min2, const Eigen::Vector3d& max2)
+	{
+		return (min1.array() <= max2.array()).all() &&
+					 (min2.array() <= max1.array()).all();
+	}
+} // namespace aabb_detail
+
+aabb_tree::aabb_tree(const unsigned int& leafSize) : mLeafSize(leafSize)
+{
+	if (mLeafSize == 0)
+	{
+		std::stringstream errorMessage;
+		errorMessage << "\nCannot initialize an AABB tree with a leaf size of zero\n"
+								 << "(bso/utilities/aabb_tree.cpp)" << std::endl;
+		throw std::invalid_argument(errorMessage.str());
+	}
+} // ctor()
+
+aabb_tree::~aabb_tree()
+{
+
+} // dtor()
+
+long aabb_tree::mBuildNode(const unsigned long& begin, const unsigned long& end)
+{
+	long index = mNodes.size();
+	mNodes.emplace_back();
+	tree_node node;
+	node.mBegin = begin;
+	node.mEnd = end;
+	node.mMin.setConstant( std::numeric_limits<double>::infinity());
+	node.mMax.setConstant(-std::numeric_limits<double>::infinity());
+	Eigen::Vector3d centerMin = node.mMin, centerMax = node.mMax;
+	for (unsigned long i = begin; i < end; ++i)
+	{
+		node.mMin = node.mMin.cwiseMin(mItemMin.col(mItems[i]));
+		node.mMax = node.mMax.cwiseMax(mItemMax.col(mItems[i]));
+		Eigen::Vector3d center = mItemMin.col(mItems[i]) + mItemMax.col(mItems[i]);
+		centerMin = centerMin.cwiseMin(center);
+		centerMax = centerMax.cwiseMax(center);
+	}
+
+	Eigen::Vector3d::Index axis;
+	double spread = (centerMax - centerMin).maxCoeff(&axis);
+	if (end - begin > mLeafSize && spread > 0.0)
+	{ // split at the median of the box centers along the axis with the largest spread
+		unsigned long middle = begin + (end - begin)/2;
+		std::nth_element(mItems.begin()+begin, mItems.begin()+middle, mItems.begin()+end,
+			[&](const unsigned long& a, const unsigned long& b)
+			{
+				return mItemMin(axis,a) + mItemMax(axis,a) < mItemMin(axis,b) + mItemMax(axis,b);
+			});
+		node.mLeft  = mBuildNode(begin, middle);
+		node.mRight = mBuildNode(middle, end);
+	}
+	mNodes[index] = node;
+	return index;
+} // mBuildNode()
+
+void aabb_tree::build(const Eigen::Matrix3Xd& minCorners, const Eigen::Matrix3Xd& maxCorners)
+{
+	if (minCorners.cols() != maxCorners.cols())
+	{
+		std::stringstream errorMessage;
+		errorMessage << "\nCannot build an AABB tree from " << minCorners.cols()
+								 << " minimum and " << maxCorners.cols() << " maximum corners\n"
+								 << "(bso/utilities/aabb_tree.cpp)" << std::endl;
+		throw std::invalid_argument(errorMessage.str());
+	}
+	this->clear();
+	mItemMin = minCorners;
+	mItemMax = maxCorners;
+	mItems.resize(mItemMin.cols());
+	for (unsigned long i = 0; i < mItems.size(); ++i) mItems[i] = i;
+	if (!mItems.empty())
+	{
+		mNodes.reserve(2*(mItems.size()/mLeafSize + 1));
+		mBuildNode(0, mItems.size());
+	}
+} // build()
+
+void aabb_tree::clear()
+{
+	mNodes.clear();
+	mItems.clear();
+	mItemMin.resize(3,0);
+	mItemMax.resize(3,0);
+} // clear()
+
+void aabb_tree::findContainedIn(const Eigen::Vector3d& min, const Eigen::Vector3d& max,
+	std::vector<unsigned long>& items) const
+{
+	items.clear();
+	if (mNodes.empty()) return;
+	std::vector<long> stack = {0};
+	while (!stack.empty())
+	{
+		const tree_node& node = mNodes[stack.back()];
+		stack.pop_back();
+		if (!aabb_detail::intersects(min, max, node.mMin, node.mMax)) continue;
+		if (aabb_detail::contains(min, max, node.mMin, node.mMax))
+		{ // all items of this node are contained
+			items.insert(items.end(), mItems.begin()+node.mBegin, mItems.begin()+node.mEnd);
+		}
+		else if (node.mLeft == -1)
+		{
+			for (unsigned long i = node.mBegin; i < node.mEnd; ++i)
+			{
+				if (aabb_detail::contains(min, max, mItemMin.col(mItems[i]), mItemMax.col(mItems[i])))
+				{
+					items.push_back(mItems[i]);
+				}
+			}
+		}
+		else
+		{
+			stack.push_back(node.mRight);
+			stack.push_back(node.mLeft);
+		}
+	}
+	std::sort(items.begin(), items.end());
+} // findContainedIn()
+
+void aabb_tree::findIntersecting(const Eigen::Vector3d& min, const Eigen::Vector3d& max,
+	std::vector<unsigned long>& items) const
+{
+	items.clear();
+	if (mNodes.empty()) return;
+	std::vector<long> stack = {0};
+	while (!stack.empty())
+	{
+		const tree_node& node = mNodes[stack.back()];
+		stack.pop_back();
+		if (!aabb_detail::intersects(min, max, node.mMin, node.mMax)) continue;
+		if (aabb_detail::contains(min, max, node.mMin, node.mMax))
+		{ // all items of this node intersect
+			items.insert(items.end(), mItems.begin()+node.mBegin, mItems.begin()+node.mEnd);
+		}
+		else if (node.mLeft == -1)
+		{
+			for (unsigned long i = node.mBegin; i < node.mEnd; ++i)
+			{
+				if (aabb_detail::intersects(min, max, mItemMin.col(mItems[i]), mItemMax.col(mItems[i])))
+				{
+					items.push_back(mItems[i]);
+				}
+			}
+		}
+		else
+		{
+			stack.push_back(node.mRight);
+			stack.push_back(node.mLeft);
+		}
+	}
+	std::sort(items.begin(), items.end());
+} // findIntersecting()
+
+template <class CONTAINER>
+void bounding_box(const CONTAINER& vertices, Eigen::Vector3d& min, Eigen::Vector3d& max)
+{
+	min.setConstant( std::numeric_limits<double>::infinity());
+	max.setConstant(-std::numeric_limits<double>::infinity());
+	for (const auto& i : vertices)
+	{
+		min = min.cwiseMin(i);
+		max = max.cwiseMax(i);
+	}
+} // bounding_box()
+
+} // namespace utilities
+} // namespace bso
+
+#endif // BSO_AABB_TREE_CPP
@@ -0,0 +1,58 @@
+#ifndef BSO_AABB_TREE_HPP
+#define BSO_AABB_TREE_HPP
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace bso { namespace utilities {
+
+	/*
+	 * Bounding volume hierarchy of axis aligned bounding boxes (AABB). Each item
+	 * is represented by its box, the tree is built top down by splitting the
+	 * items at the median of their box centers along the longest axis. A query
+	 * only visits the tree nodes of which the box intersects the query box, and
+	 * returns the indices of the items in ascending order.
+	 */
+
+	class aabb_tree
+	{
+	private:
+		struct tree_node
+		{
+			Eigen::Vector3d mMin, mMax; // box that encloses all items of this node
+			unsigned long mBegin, mEnd; // range of this node in mItems
+			long mLeft = -1, mRight = -1; // children, -1 for a leaf
+		};
+
+		unsigned int mLeafSize;
+		std::vector<tree_node> mNodes; // root at index 0
+		std::vector<unsigned long> mItems; // item indices, each node covers a contiguous range
+		Eigen::Matrix3Xd mItemMin, mItemMax;
+
+		long mBuildNode(const unsigned long& begin, const unsigned long& end);
+	public:
+		aabb_tree(const unsigned int& leafSize = 8);
+		~aabb_tree();
+
+		void build(const Eigen::Matrix3Xd& minCorners, const Eigen::Matrix3Xd& maxCorners); // one column per item
+		void clear();
+
+		void findContainedIn(const Eigen::Vector3d& min, const Eigen::Vector3d& max,
+			std::vector<unsigned long>& items) const; // items of which the box lies inside or on [min,max]
+		void findIntersecting(const Eigen::Vector3d& min, const Eigen::Vector3d& max,
+			std::vector<unsigned long>& items) const; // items of which the box touches [min,max]
+
+		unsigned long size() const {return mItemMin.cols();}
+		unsigned long nodeCount() const {return mNodes.size();}
+	};
+
+	template <class CONTAINER>
+	void bounding_box(const CONTAINER& vertices, Eigen::Vector3d& min, Eigen::Vector3d& max); // AABB of a range of vertices
+
+} // namespace utilities
+} // namespace bso
+
+#include <bso/utilities/aabb_tree.cpp>
+
+#endif // BSO_AABB_TREE_HPP
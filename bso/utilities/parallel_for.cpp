@@ -0,0 +1,60 @@
+#ifndef BSO_PARALLEL_FOR_CPP
+#define BSO_PARALLEL_FOR_CPP
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace bso { namespace utilities {
+
+	template <typename FUNCTION>
+	void parallel_for(const unsigned long& begin, const unsigned long& end,
+		unsigned int threadCount, FUNCTION f)
+	{
+		if (end <= begin) return;
+		unsigned long size = end - begin;
+		if (threadCount == 0) threadCount = 1;
+		if (threadCount > size) threadCount = size;
+		if (threadCount == 1)
+		{
+			for (unsigned long i = begin; i < end; ++i) f(i);
+			return;
+		}
+
+		std::vector<std::exception_ptr> exceptions(threadCount);
+		std::vector<std::thread> threads;
+		threads.reserve(threadCount);
+		for (unsigned int t = 0; t < threadCount; ++t)
+		{
+			unsigned long blockBegin = begin + (size*t)/threadCount;
+			unsigned long blockEnd = begin + (size*(t+1))/threadCount;
+			threads.push_back(std::thread([&f, &exceptions, t, blockBegin, blockEnd]()
+			{
+				try
+				{
+					for (unsigned long i = blockBegin; i < blockEnd; ++i) f(i);
+				}
+				catch (...)
+				{
+					exceptions[t] = std::current_exception();
+				}
+			}));
+		}
+		for (auto& i : threads) i.join();
+		for (auto& i : exceptions)
+		{
+			if (i) std::rethrow_exception(i);
+		}
+	} // parallel_for()
+
+	unsigned int default_thread_count()
+	{
+		unsigned int threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0) threadCount = 1;
+		return threadCount;
+	} // default_thread_count()
+
+} // namespace utilities
+} // namespace bso
+
+#endif // BSO_PARALLEL_FOR_CPP
@@ -0,0 +1,24 @@
+#ifndef BSO_PARALLEL_FOR_HPP
+#define BSO_PARALLEL_FOR_HPP
+
+namespace bso { namespace utilities {
+
+	/*
+	 * Calls f(i) for each i in [begin, end). The range is split in contiguous
+	 * blocks, one for each thread, and each block is processed in order. With
+	 * one thread (or an empty range) f is called on the calling thread. The
+	 * first exception that is thrown by f is rethrown after all threads joined.
+	 */
+
+	template <typename FUNCTION>
+	void parallel_for(const unsigned long& begin, const unsigned long& end,
+		unsigned int threadCount, FUNCTION f);
+
+	unsigned int default_thread_count(); // number of hardware threads, at least 1
+
+} // namespace utilities
+} // namespace bso
+
+#include <bso/utilities/parallel_for.cpp>
+
+#endif // BSO_PARALLEL_FOR_HPP
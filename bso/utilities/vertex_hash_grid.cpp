@@ -0,0 +1,116 @@
+#ifndef BSO_VERTEX_HASH_GRID_CPP
+#define BSO_VERTEX_HASH_GRID_CPP
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace bso { namespace utilities {
+
+std::size_t vertex_hash_grid::cell_key_hash::operator()(const cell_key& k) const
+{ // combine the three cell indices with large primes
+	return (std::size_t)(k[0]*73856093LL) ^ (std::size_t)(k[1]*19349663LL)
+		^ (std::size_t)(k[2]*83492791LL);
+} // operator()
+
+long long vertex_hash_grid::mQuantize(const double& x) const
+{
+	return (long long)std::floor(x/mCellSize);
+} // mQuantize()
+
+vertex_hash_grid::cell_key vertex_hash_grid::mCellOf(
+	const bso::utilities::geometry::vertex& v) const
+{
+	return {mQuantize(v(0)), mQuantize(v(1)), mQuantize(v(2))};
+} // mCellOf()
+
+vertex_hash_grid::vertex_hash_grid(const double& cellSize) : mCellSize(cellSize)
+{
+	if (!(mCellSize > 0))
+	{
+		std::stringstream errorMessage;
+		errorMessage << "\nCannot initialize vertex hash grid with a cell size of: "
+								 << mCellSize << "\n"
+								 << "(bso/utilities/vertex_hash_grid.cpp)" << std::endl;
+		throw std::invalid_argument(errorMessage.str());
+	}
+} // ctor()
+
+vertex_hash_grid::~vertex_hash_grid()
+{
+
+} // dtor()
+
+unsigned long vertex_hash_grid::insert(const bso::utilities::geometry::vertex& v)
+{
+	unsigned long index = mVertices.size();
+	mVertices.push_back(v);
+	mCells[mCellOf(v)].push_back(index);
+	return index;
+} // insert()
+
+bool vertex_hash_grid::find(const bso::utilities::geometry::vertex& v,
+	unsigned long& index, const double& tol) const
+{
+	// isSameAs() compares each coordinate separately, so all candidates lie in
+	// the cells that overlap the box [v-tol, v+tol]. The box is slightly
+	// enlarged to be safe against rounding in the quantization.
+	double reach = 2.0*tol;
+	cell_key lower, upper;
+	double cellCount = 1.0;
+	for (unsigned int i = 0; i < 3; ++i)
+	{
+		lower[i] = mQuantize(v(i)-reach);
+		upper[i] = mQuantize(v(i)+reach);
+		cellCount *= (double)(upper[i]-lower[i]+1);
+	}
+
+	bool found = false;
+	if (cellCount > (double)mCells.size())
+	{ // the tolerance is large compared to the cell size, check all vertices
+		for (unsigned long i = 0; i < mVertices.size(); ++i)
+		{
+			if (mVertices[i].isSameAs(v,tol))
+			{
+				index = i;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	cell_key key;
+	for (key[0] = lower[0]; key[0] <= upper[0]; ++key[0])
+	{
+		for (key[1] = lower[1]; key[1] <= upper[1]; ++key[1])
+		{
+			for (key[2] = lower[2]; key[2] <= upper[2]; ++key[2])
+			{
+				auto cellSearch = mCells.find(key);
+				if (cellSearch == mCells.end()) continue;
+				for (const auto& i : cellSearch->second)
+				{ // keep the first inserted match, as a linear search would
+					if (found && i >= index) break;
+					if (mVertices[i].isSameAs(v,tol))
+					{
+						index = i;
+						found = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+	return found;
+} // find()
+
+void vertex_hash_grid::clear()
+{
+	mVertices.clear();
+	mCells.clear();
+} // clear()
+
+} // namespace utilities
+} // namespace bso
+
+#endif // BSO_VERTEX_HASH_GRID_CPP
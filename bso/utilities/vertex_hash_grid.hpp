@@ -0,0 +1,54 @@
+#ifndef BSO_VERTEX_HASH_GRID_HPP
+#define BSO_VERTEX_HASH_GRID_HPP
+
+#include <bso/utilities/geometry/vertex.hpp>
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+namespace bso { namespace utilities {
+
+	/*
+	 * Spatial hash of vertices, the vertices are stored in buckets that are keyed
+	 * by their quantized coordinates. A lookup only checks the vertices in the
+	 * buckets that lie within the tolerance of the requested vertex, and
+	 * returns the index of the first inserted vertex that is the same as it
+	 * (i.e. the same vertex that a linear search with isSameAs() would find)
+	 */
+
+	class vertex_hash_grid
+	{
+	private:
+		typedef std::array<long long, 3> cell_key;
+		struct cell_key_hash
+		{
+			std::size_t operator()(const cell_key& k) const;
+		};
+
+		double mCellSize;
+		std::vector<bso::utilities::geometry::vertex> mVertices; // in order of insertion
+		std::unordered_map<cell_key, std::vector<unsigned long>, cell_key_hash> mCells; // indices of the vertices in each cell
+
+		long long mQuantize(const double& x) const;
+		cell_key mCellOf(const bso::utilities::geometry::vertex& v) const;
+	public:
+		vertex_hash_grid(const double& cellSize = 1e-6);
+		~vertex_hash_grid();
+
+		unsigned long insert(const bso::utilities::geometry::vertex& v); // returns the index of v in the grid
+		bool find(const bso::utilities::geometry::vertex& v, unsigned long& index,
+			const double& tol = 1e-9) const; // finds the first inserted vertex that is the same as v
+		void clear();
+
+		const double& getCellSize() const {return mCellSize;}
+		unsigned long size() const {return mVertices.size();}
+		const bso::utilities::geometry::vertex& operator[](const unsigned long& index) const {return mVertices[index];}
+	};
+
+} // namespace utilities
+} // namespace bso
+
+#include <bso/utilities/vertex_hash_grid.cpp>
+
+#endif // BSO_VERTEX_HASH_GRID_HPP
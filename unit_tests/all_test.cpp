@@ -6,6 +6,9 @@
 
 #include <unit_tests/utilities/trim_and_cast_test.cpp>
 #include <unit_tests/utilities/geometry_test.cpp>
+#include <unit_tests/utilities/vertex_hash_grid_test.cpp>
+#include <unit_tests/utilities/parallel_for_test.cpp>
+#include <unit_tests/utilities/aabb_tree_test.cpp>
 #include <unit_tests/utilities/data_handling_test.cpp>
 #include <unit_tests/spatial_design/ms_space_test.cpp>
 #include <unit_tests/spatial_design/ms_building_test.cpp>
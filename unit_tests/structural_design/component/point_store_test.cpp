@@ -0,0 +1,58 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_point_store_component"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/component/point_store.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace component_test {
+using namespace bso::structural_design::component;
+
+BOOST_AUTO_TEST_SUITE( sd_point_store_component )
+	
+	BOOST_AUTO_TEST_CASE( empty_init )
+	{
+		point_store ps1;
+		BOOST_REQUIRE(ps1.size() == 0);
+		BOOST_REQUIRE(ps1.findPoint({0,0,0}) == nullptr);
+	}
+	
+	BOOST_AUTO_TEST_CASE( add_points )
+	{
+		point_store ps1;
+		auto p1 = ps1.addPoint({0,0,0});
+		auto p2 = ps1.addPoint({1000,0,0});
+		auto p3 = ps1.addPoint({1000+1e-10,0,0});
+		
+		BOOST_REQUIRE(ps1.size() == 2);
+		BOOST_REQUIRE(p1->getID() == 0);
+		BOOST_REQUIRE(p2->getID() == 1);
+		BOOST_REQUIRE(p3 == p2);
+		BOOST_REQUIRE(ps1[0] == p1);
+		BOOST_REQUIRE(ps1.back() == p2);
+		BOOST_REQUIRE(ps1.findPoint({1000,0,0}) == p2);
+		BOOST_REQUIRE(ps1.findPoint({1000,0,1}) == nullptr);
+	}
+	
+	BOOST_AUTO_TEST_CASE( clear )
+	{
+		point_store ps1;
+		ps1.addPoint({0,0,0});
+		ps1.addPoint({0,0,1});
+		ps1.clear();
+		
+		BOOST_REQUIRE(ps1.size() == 0);
+		BOOST_REQUIRE(ps1.findPoint({0,0,0}) == nullptr);
+		BOOST_REQUIRE(ps1.addPoint({0,0,1})->getID() == 0);
+	}
+	
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace component_test
@@ -125,7 +125,7 @@ BOOST_AUTO_TEST_SUITE( sd_quad_hexahedrononent )
 		structure st1("quad_hexahedron",{{"poisson",0.3},{"E",1e5}});
 		qh1.addStructure(st1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		qh1.mesh(2,pointStore);
 
 		BOOST_REQUIRE(qh1.getElementPoints().size() == 8);
@@ -186,7 +186,7 @@ BOOST_AUTO_TEST_SUITE( sd_quad_hexahedrononent )
 		load l1(lc1,80,0);
 		qh1.addLoad(l1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		qh1.mesh(2,pointStore);
 		
 		double loadSum = 0;
@@ -224,7 +224,7 @@ BOOST_AUTO_TEST_SUITE( sd_quad_hexahedrononent )
 		constraint c1(5);
 		qh1.addConstraint(c1);
 		
-		std::vector<point*> pointStore;
+		point_store pointStore;
 		qh1.mesh(2,pointStore);
 		
 		for (auto& i : pointStore)
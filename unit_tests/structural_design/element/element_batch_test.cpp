@@ -0,0 +1,98 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_element_batch"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/fea.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace element_test {
+using namespace bso::structural_design::element;
+
+BOOST_AUTO_TEST_SUITE( sd_element_batch_test )
+
+	BOOST_AUTO_TEST_CASE( initialization )
+	{
+		element_batch b1;
+		BOOST_REQUIRE(b1.size() == 0);
+		BOOST_REQUIRE(b1.matrixCount() == 0);
+
+		node n1({0,0,0},1), n2({1000,0,0},2);
+		truss t1(1,1e5,100,{&n1,&n2});
+		std::vector<element*> elements = {&t1};
+		BOOST_REQUIRE_THROW(b1.build(elements), std::runtime_error); // no element freedom table yet
+	}
+
+	BOOST_AUTO_TEST_CASE( energies_and_sensitivities )
+	{
+		bso::structural_design::fea testFEA;
+		node* n1 = testFEA.addNode({   0,   0,0});
+		node* n2 = testFEA.addNode({1000,   0,0});
+		node* n3 = testFEA.addNode({1000,1000,0});
+		node* n4 = testFEA.addNode({   0,1000,0});
+		node* n5 = testFEA.addNode({2000,   0,0});
+		node* n6 = testFEA.addNode({2000,1000,0});
+		node* n7 = testFEA.addNode({   0,   0,1000});
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			n1->addConstraint(i);
+			n4->addConstraint(i);
+		}
+		load_case lc1("wind"), lc2("live");
+		n6->addLoad(load(lc1,1e3,0));
+		n5->addLoad(load(lc2,-1e3,2));
+		n7->addLoad(load(lc2,-1e3,1));
+
+		stiffness_cache cache;
+		testFEA.addElement(new flat_shell(0,1e5,50,0.3,{n1,n2,n3,n4},1e-6,1e-3,&cache));
+		testFEA.addElement(new beam(1,1e5,100,100,0.3,{n1,n7}));
+		testFEA.addElement(new flat_shell(2,1e5,50,0.3,{n2,n5,n6,n3},1e-6,1e-3,&cache));
+		testFEA.addElement(new truss(3,1e5,1e3,{n3,n7}));
+
+		double penal = 3.0;
+		Eigen::VectorXd densities(4);
+		densities << 0.3, 0.7, 1.0, 0.5;
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			testFEA.getElements()[i]->updateDensity(densities(i),penal);
+		}
+		testFEA.generateGSM();
+		testFEA.solve();
+
+		element_batch b1(testFEA.getElements());
+		BOOST_REQUIRE(b1.size() == 4);
+		BOOST_REQUIRE(b1.matrixCount() == 3); // the flat shells share their stiffness matrix
+		BOOST_REQUIRE_THROW(b1.compute(testFEA.getDisplacements(),Eigen::VectorXd::Ones(3),penal),
+												std::invalid_argument);
+
+		b1.compute(testFEA.getDisplacements(),densities,penal);
+		double totalEnergy = 0;
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			const auto& ele = testFEA.getElements()[i];
+			totalEnergy += ele->getTotalEnergy();
+			BOOST_REQUIRE(std::abs(b1.getEnergies()(i) - ele->getTotalEnergy()) <=
+										1e-12 * std::abs(ele->getTotalEnergy()));
+			BOOST_REQUIRE(std::abs(b1.getEnergySensitivities()(i) - ele->getEnergySensitivity(penal)) <=
+										1e-12 * std::abs(ele->getEnergySensitivity(penal)));
+		}
+		BOOST_REQUIRE(std::abs(b1.getTotalEnergy()/totalEnergy - 1) < 1e-12);
+
+		// a batch of a subset of the elements, in a different order
+		std::vector<element*> subset = {testFEA.getElements()[3], testFEA.getElements()[1]};
+		element_batch b2(subset);
+		b2.compute(testFEA.getDisplacements(),Eigen::Vector2d(0.5,0.7),penal);
+		BOOST_REQUIRE(b2.matrixCount() == 2);
+		BOOST_REQUIRE(b2.getEnergies()(0) == b1.getEnergies()(3));
+		BOOST_REQUIRE(b2.getEnergies()(1) == b1.getEnergies()(1));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace element_test
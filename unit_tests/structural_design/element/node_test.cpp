@@ -126,6 +126,21 @@ BOOST_AUTO_TEST_SUITE( sd_node_test )
 			BOOST_REQUIRE(n.getDisplacements(lc1)[i] == check1[i]);
 		}
 		BOOST_REQUIRE_THROW(auto temp = n.getDisplacements(lc2), std::runtime_error);
+		
+		// one column per load case, accessible by load case and by its index
+		Eigen::MatrixXd displacementMatrix(3,2);
+		displacementMatrix << 0.5, 1.5,
+													0.3, 1.3,
+													0.4, 1.4;
+		n.addDisplacements(displacementMatrix,{lc2,lc1});
+		std::vector<double> check2 = {1.5,1.3,0,0,1.4,0};
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			BOOST_REQUIRE(n.getDisplacements(lc2)[i] == check1[i]);
+			BOOST_REQUIRE(n.getDisplacements(lc1)[i] == check2[i]);
+			BOOST_REQUIRE(n.getDisplacements(1)[i] == check2[i]);
+		}
+		BOOST_REQUIRE_THROW(n.getDisplacements(2), std::runtime_error);
 	}
 	
 	BOOST_AUTO_TEST_CASE( generate_nodal_freedom_table )
@@ -140,6 +155,8 @@ BOOST_AUTO_TEST_SUITE( sd_node_test )
 		BOOST_REQUIRE(NFM == 7);
 		BOOST_REQUIRE(n.getGlobalDOF(1) == 5);
 		BOOST_REQUIRE(n.getGlobalDOF(4) == 6);
+		std::array<long,6> checkNFT = {{-1,5,-1,-1,6,-1}};
+		BOOST_REQUIRE(n.getNFT() == checkNFT);
 		BOOST_REQUIRE_THROW(n.getGlobalDOF(0), std::invalid_argument);
 		BOOST_REQUIRE_THROW(n.getGlobalDOF(7), std::runtime_error);
 	}
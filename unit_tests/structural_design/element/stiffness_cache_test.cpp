@@ -0,0 +1,111 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_stiffness_cache"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/element/elements.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace element_test {
+using namespace bso::structural_design::element;
+
+BOOST_AUTO_TEST_SUITE( sd_stiffness_cache_test )
+
+	BOOST_AUTO_TEST_CASE( initialization )
+	{
+		stiffness_cache c1;
+		BOOST_REQUIRE(c1.size() == 0);
+		BOOST_REQUIRE(c1.getResolution() == 1e-6);
+		BOOST_REQUIRE_THROW(stiffness_cache c2(0.0), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( signatures )
+	{
+		stiffness_cache c1(1e-3);
+		std::vector<bso::utilities::geometry::vertex> v1 = {{0,0,0},{1,0,0}};
+		std::vector<bso::utilities::geometry::vertex> v2 = {{5,5,5},{6,5,5+1e-5}};
+		std::vector<bso::utilities::geometry::vertex> v3 = {{0,0,0},{0,1,0}};
+		auto s1 = c1.makeSignature("truss",{1.0,2.0},v1);
+		BOOST_REQUIRE(s1 == c1.makeSignature("truss",{1.0,2.0},v2));
+		BOOST_REQUIRE(!(s1 == c1.makeSignature("truss",{1.0,2.0},v3)));
+		BOOST_REQUIRE(!(s1 == c1.makeSignature("beam",{1.0,2.0},v1)));
+		BOOST_REQUIRE(!(s1 == c1.makeSignature("truss",{1.0,2.0+1e-12},v1)));
+
+		std::shared_ptr<const double> d1;
+		BOOST_REQUIRE(!c1.find(s1,d1));
+		c1.insert(s1,std::shared_ptr<const double>(new double(3.0)));
+		BOOST_REQUIRE(c1.find(s1,d1));
+		BOOST_REQUIRE(*d1 == 3.0);
+		BOOST_REQUIRE(c1.hitCount() == 1);
+		c1.clear();
+		BOOST_REQUIRE(c1.size() == 0);
+	}
+
+	BOOST_AUTO_TEST_CASE( congruent_flat_shells )
+	{
+		node n1({   0,   0,0},1), n2({1000,   0,0},2), n3({1000,1000,0},3), n4({   0,1000,0},4);
+		node n5({2000,   0,0},5), n6({3000,   0,0},6), n7({3000,1000,0},7), n8({2000,1000,0},8);
+		node n9({   0,   0,0},9), n10({1000,   0,0},10), n11({1000,0,1000},11), n12({   0,0,1000},12);
+
+		stiffness_cache c1;
+		flat_shell fs1(1,1e5,100,0.3,{&n1,&n2,&n3,&n4},1e-6,1e-3,&c1);
+		flat_shell fs2(2,1e5,100,0.3,{&n5,&n6,&n7,&n8},1e-6,1e-3,&c1);
+		flat_shell fs3(3,1e5,150,0.3,{&n5,&n6,&n7,&n8},1e-6,1e-3,&c1);
+		flat_shell fs4(4,1e5,100,0.3,{&n9,&n10,&n11,&n12},1e-6,1e-3,&c1);
+		BOOST_REQUIRE(fs1.sharesStiffnessWith(fs2));
+		BOOST_REQUIRE(!fs1.sharesStiffnessWith(fs3));
+		BOOST_REQUIRE(!fs1.sharesStiffnessWith(fs4));
+		BOOST_REQUIRE(c1.size() == 3);
+		BOOST_REQUIRE(c1.hitCount() == 1);
+
+		// the shared stiffness matrix is the same as the one derived without a cache
+		flat_shell fs5(5,1e5,100,0.3,{&n5,&n6,&n7,&n8});
+		Eigen::MatrixXd checkSM = fs5.getOriginalSM();
+		BOOST_REQUIRE(checkSM.isApprox(fs2.getOriginalSM(),1e-12));
+	}
+
+	BOOST_AUTO_TEST_CASE( congruent_beams_and_quad_hexahedrons )
+	{
+		node n1({0,0,0},1), n2({1000,0,0},2), n3({1000,0,0},3), n4({2000,0,0},4);
+		stiffness_cache c1;
+		beam b1(1,1e5,100,200,0.3,{&n1,&n2},1e-6,&c1);
+		beam b2(2,1e5,100,200,0.3,{&n3,&n4},1e-6,&c1);
+		truss t1(3,1e5,100,{&n1,&n2},1e-6,&c1);
+		truss t2(4,1e5,100,{&n3,&n4},1e-6,&c1);
+		BOOST_REQUIRE(b1.sharesStiffnessWith(b2));
+		BOOST_REQUIRE(t1.sharesStiffnessWith(t2));
+
+		std::vector<node*> h1, h2;
+		std::vector<node> hexNodes;
+		hexNodes.reserve(16);
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			for (unsigned int j = 0; j < 8; ++j)
+			{
+				hexNodes.push_back(node({1000.0*((j & 1) + 2*i),1000.0*((j >> 1) & 1),1000.0*(j >> 2)},8*i+j));
+			}
+		}
+		for (unsigned int j = 0; j < 8; ++j)
+		{
+			h1.push_back(&hexNodes[j]);
+			h2.push_back(&hexNodes[8+j]);
+		}
+		quad_hexahedron qh1(5,1e5,0.3,h1,1e-6,1e-3,&c1);
+		quad_hexahedron qh2(6,1e5,0.3,h2,1e-6,1e-3,&c1);
+		quad_hexahedron qh3(7,1e5,0.3,h2);
+		BOOST_REQUIRE(qh1.sharesStiffnessWith(qh2));
+		BOOST_REQUIRE(!qh1.sharesStiffnessWith(qh3));
+		Eigen::MatrixXd checkSM = qh3.getOriginalSM();
+		BOOST_REQUIRE(checkSM.isApprox(qh2.getOriginalSM(),1e-12));
+		BOOST_REQUIRE(c1.hitCount() == 3);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace element_test
@@ -96,8 +96,12 @@ BOOST_AUTO_TEST_SUITE( sd_truss_test )
 		truss t1(1,E,A,{&n1,&n2});
 		
 		BOOST_REQUIRE( t1.getDensity() == 1);
+		BOOST_REQUIRE( t1.getStiffnessFactor() == 1);
+		Eigen::MatrixXd originalSM = t1.getOriginalSM();
 		t1.updateDensity(0.3);
 		BOOST_REQUIRE( t1.getDensity() == 0.3);
+		BOOST_REQUIRE( abs(t1.getStiffnessFactor() - (0.1 + 0.3*(E - 0.1))/E) < 1e-12);
+		BOOST_REQUIRE( t1.getOriginalSM() == originalSM);
 	}
 	
 	BOOST_AUTO_TEST_CASE( stiffness_terms )
@@ -123,5 +123,424 @@ BOOST_AUTO_TEST_SUITE( sd_fea_test )
 		BOOST_REQUIRE_THROW(testFEA.solve("notASolver"), std::invalid_argument);
 	}
 
+	BOOST_AUTO_TEST_CASE( solve_after_density_update )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1,0,0});
+		
+		n1->addConstraint(0);
+		n1->addConstraint(1);
+		n1->addConstraint(2);
+		n2->addConstraint(1);
+		n2->addConstraint(2);
+		
+		element::load_case lc1("test_case");
+		element::load l1(lc1,1e9,0);
+		n2->addLoad(l1);
+
+		testFEA.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		for (std::string solver : {"SimplicialLLT", "SimplicialLDLT"})
+		{
+			testFEA.getElements()[0]->updateDensity(1.0,1,"regularSIMP");
+			testFEA.generateGSM();
+			testFEA.solve(solver);
+			BOOST_REQUIRE(abs(n2->getDisplacements(lc1)(0)/10-1) < 1e-9);
+			
+			// same sparsity pattern, only the numerical factorization is redone
+			testFEA.getElements()[0]->updateDensity(0.5,1,"regularSIMP");
+			testFEA.generateGSM();
+			testFEA.solve(solver);
+			BOOST_REQUIRE(abs(n2->getDisplacements(lc1)(0)/20-1) < 1e-9);
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( reassemble_GSM )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1000,0,0});
+		element::node* n3 = testFEA.addNode({1000,1000,0});
+		element::node* n4 = testFEA.addNode({0,1000,0});
+		for (unsigned int i = 0; i < 6; ++i) n1->addConstraint(i);
+		for (unsigned int i = 2; i < 6; ++i) n2->addConstraint(i);
+		
+		testFEA.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		testFEA.addElement(new element::beam(1,1e5,100,100,0.3,{n2,n3}));
+		testFEA.addElement(new element::flat_shell(2,1e5,50,0.3,{n1,n2,n3,n4}));
+		testFEA.generateGSM();
+		unsigned long nonZeros = testFEA.getGSM().nonZeros();
+		
+		// the reassembled GSM must equal a GSM assembled from the triplets
+		std::vector<double> densities = {0.3, 0.7, 0.5};
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			testFEA.getElements()[i]->updateDensity(densities[i],3);
+		}
+		testFEA.generateGSM();
+		
+		std::vector<element::triplet> triplets;
+		for (const auto& i : testFEA.getElements())
+		{
+			auto trips = i->getSMTriplets();
+			triplets.insert(triplets.end(), trips.begin(), trips.end());
+		}
+		Eigen::SparseMatrix<double> checkGSM(testFEA.getDOFCount(),testFEA.getDOFCount());
+		checkGSM.setFromTriplets(triplets.begin(), triplets.end());
+		
+		BOOST_REQUIRE((unsigned long)testFEA.getGSM().nonZeros() == nonZeros);
+		BOOST_REQUIRE((testFEA.getGSM() - checkGSM).norm() < 1e-14 * checkGSM.norm()); // the density scaling may be fused with the summation
+	}
+
+	BOOST_AUTO_TEST_CASE( solve_parallel )
+	{
+		fea serialFEA, parallelFEA;
+		for (auto FEA : {&serialFEA, &parallelFEA})
+		{
+			element::node* n1 = FEA->addNode({0,0,0});
+			element::node* n2 = FEA->addNode({1000,0,0});
+			element::node* n3 = FEA->addNode({1000,1000,0});
+			element::node* n4 = FEA->addNode({0,1000,0});
+			element::node* n5 = FEA->addNode({0,0,1000});
+			for (unsigned int i = 0; i < 6; ++i)
+			{
+				n1->addConstraint(i);
+				n2->addConstraint(i);
+			}
+			
+			element::load_case lc1("wind"), lc2("live");
+			n3->addLoad(element::load(lc1,1e3,0));
+			n4->addLoad(element::load(lc1,1e3,0));
+			n3->addLoad(element::load(lc2,-1e3,2));
+			n5->addLoad(element::load(lc2,-1e3,1));
+
+			FEA->addElement(new element::flat_shell(0,1e5,50,0.3,{n1,n2,n3,n4}));
+			FEA->addElement(new element::beam(1,1e5,100,100,0.3,{n1,n5}));
+			FEA->addElement(new element::truss(2,1e5,1e3,{n4,n5}));
+		}
+		parallelFEA.setParallel(true,2);
+		BOOST_REQUIRE(parallelFEA.isParallel());
+		BOOST_REQUIRE(parallelFEA.getThreadCount() == 2);
+		
+		for (std::string solver : {"SimplicialLLT", "SimplicialLDLT"})
+		{
+			serialFEA.generateGSM();
+			serialFEA.solve(solver);
+			parallelFEA.generateGSM();
+			parallelFEA.solve(solver);
+			
+			// results must be bit-identical to the serial path
+			for (unsigned int i = 0; i < 5; ++i)
+			{
+				for (auto lc : serialFEA.getNodes()[i]->getLoadCases())
+				{
+					BOOST_REQUIRE(serialFEA.getNodes()[i]->getDisplacements(lc) ==
+												parallelFEA.getNodes()[i]->getDisplacements(lc));
+				}
+			}
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				BOOST_REQUIRE(serialFEA.getElements()[i]->getTotalEnergy() ==
+											parallelFEA.getElements()[i]->getTotalEnergy());
+			}
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( element_results_view )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1000,0,0});
+		element::node* n3 = testFEA.addNode({1000,1000,0});
+		element::node* n4 = testFEA.addNode({0,1000,0});
+		element::node* n5 = testFEA.addNode({0,0,1000});
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			n1->addConstraint(i);
+			n2->addConstraint(i);
+		}
+		element::load_case lc1("wind"), lc2("live");
+		n3->addLoad(element::load(lc1,1e3,0));
+		n3->addLoad(element::load(lc2,-1e3,2));
+		n5->addLoad(element::load(lc2,-1e3,1));
+		testFEA.addElement(new element::flat_shell(0,1e5,50,0.3,{n1,n2,n3,n4}));
+		testFEA.addElement(new element::beam(1,1e5,100,100,0.3,{n1,n5}));
+		testFEA.addElement(new element::truss(2,1e5,1e3,{n4,n5}));
+		testFEA.getElements()[2]->isActiveInCompliance() = false;
+		testFEA.generateGSM();
+		testFEA.solve();
+		
+		const auto& results = testFEA.getElementResults();
+		BOOST_REQUIRE(results.size() == 3);
+		BOOST_REQUIRE(results.mEnergies.rows() == 3 && results.mEnergies.cols() == 2);
+		BOOST_REQUIRE(results.mTypes(0) == element_results::FLAT_SHELL);
+		BOOST_REQUIRE(results.mTypes(1) == element_results::BEAM);
+		BOOST_REQUIRE(results.mTypes(2) == element_results::TRUSS);
+		BOOST_REQUIRE(results.typeMask(element_results::BEAM) == Eigen::Vector3d(0,1,0));
+		BOOST_REQUIRE(results.mActiveInCompliance == Eigen::Vector3d(1,1,0));
+		std::vector<unsigned long> checkOffsets = {0,4,6,8};
+		std::vector<unsigned long> checkIndices = {0,1,2,3,0,4,3,4};
+		BOOST_REQUIRE(results.mNodeOffsets == checkOffsets);
+		BOOST_REQUIRE(results.mNodeIndices == checkIndices);
+		for (unsigned int i = 0; i < 3; ++i)
+		{
+			const auto& ele = testFEA.getElements()[i];
+			BOOST_REQUIRE(results.mTotalEnergy(i) == ele->getTotalEnergy());
+			BOOST_REQUIRE(results.mVolume(i) == ele->getVolume());
+			BOOST_REQUIRE(ele->getCenter().isSameAs(results.mCenters.col(i)));
+			for (unsigned int j = 0; j < 2; ++j)
+			{
+				BOOST_REQUIRE(results.mEnergies(i,j) == ele->getEnergy(testFEA.getLoadCases()[j]));
+			}
+		}
+		BOOST_REQUIRE(results.mShearEnergy(0) == testFEA.getElements()[0]->getTotalEnergy("shear"));
+		BOOST_REQUIRE(results.mShearEnergy(1) == 0.0);
+		
+		testFEA.clearResponse();
+		BOOST_REQUIRE(testFEA.getElementResults().mTotalEnergy.isZero());
+	}
+
+	BOOST_AUTO_TEST_CASE( load_case_matrices )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1,0,0});
+		
+		n1->addConstraint(0);
+		n1->addConstraint(1);
+		n1->addConstraint(2);
+		n2->addConstraint(1);
+		n2->addConstraint(2);
+		
+		element::load_case lc1("test_case_1"), lc2("test_case_2");
+		n2->addLoad(element::load(lc1,1e9,0));
+		n2->addLoad(element::load(lc2,-2e9,0));
+
+		testFEA.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		testFEA.generateGSM();
+		testFEA.solve();
+		
+		BOOST_REQUIRE(testFEA.getLoadCases().size() == 2);
+		BOOST_REQUIRE(testFEA.getLoads().rows() == 1);
+		BOOST_REQUIRE(testFEA.getLoads().cols() == 2);
+		BOOST_REQUIRE(testFEA.getDisplacements().cols() == 2);
+		BOOST_REQUIRE(abs(testFEA.getDisplacements(lc1)(0)/10-1) < 1e-9);
+		BOOST_REQUIRE(abs(testFEA.getDisplacements(lc2)(0)/-20-1) < 1e-9);
+		BOOST_REQUIRE(abs(n2->getDisplacements(lc1)(0)/10-1) < 1e-9);
+		BOOST_REQUIRE(abs(n2->getDisplacements(lc2)(0)/-20-1) < 1e-9);
+		BOOST_REQUIRE_THROW(testFEA.getDisplacements(element::load_case("unknown")), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( direct_solver_backends )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1000,0,0});
+		element::node* n3 = testFEA.addNode({1000,1000,0});
+		element::node* n4 = testFEA.addNode({0,1000,0});
+		element::node* n5 = testFEA.addNode({0,0,1000});
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			n1->addConstraint(i);
+			n2->addConstraint(i);
+		}
+		element::load_case lc1("test_case");
+		n3->addLoad(element::load(lc1,1e3,0));
+		n4->addLoad(element::load(lc1,-1e3,2));
+		n5->addLoad(element::load(lc1,-1e3,1));
+		testFEA.addElement(new element::flat_shell(0,1e5,50,0.3,{n1,n2,n3,n4}));
+		testFEA.addElement(new element::beam(1,1e5,100,100,0.3,{n1,n5}));
+		testFEA.addElement(new element::truss(2,1e5,1e3,{n4,n5}));
+		testFEA.generateGSM();
+		
+		testFEA.solve("SimplicialLDLT");
+		Eigen::VectorXd check = testFEA.getDisplacements(lc1);
+		for (std::string solver : {"SimplicialLLT", "CholmodSupernodalLLT", "PardisoLLT", "PardisoLDLT"})
+		{ // an unavailable backend would only compare SimplicialLDLT with itself
+			if (!solver::is_available(solver))
+			{
+				BOOST_TEST_MESSAGE("direct solver " << solver << " is not compiled in, skipped");
+				continue;
+			}
+			testFEA.solve(solver);
+			BOOST_REQUIRE((testFEA.getDisplacements(lc1) - check).norm() <= 1e-9 * check.norm());
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( solve_adjoint_sparse )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1000,0,0});
+		element::node* n3 = testFEA.addNode({1000,1000,0});
+		element::node* n4 = testFEA.addNode({0,1000,0});
+		element::node* n5 = testFEA.addNode({2000,0,0});
+		element::node* n6 = testFEA.addNode({2000,1000,0});
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			n1->addConstraint(i);
+			n4->addConstraint(i);
+		}
+		for (auto& i : {n2,n3,n5,n6}) i->addConstraint(2);
+		element::load_case lc1("test_case");
+		n6->addLoad(element::load(lc1,-1e3,1));
+		testFEA.addElement(new element::flat_shell(0,1e5,50,0.3,{n1,n2,n3,n4}));
+		testFEA.addElement(new element::flat_shell(1,1e5,50,0.3,{n2,n5,n6,n3}));
+		testFEA.generateGSM();
+		testFEA.solve();
+
+		// the element terms scattered with the EFT equal the global terms
+		unsigned long freeDOFs = testFEA.getDOFCount();
+		Eigen::MatrixXd aeDense(freeDOFs,2);
+		std::vector<Eigen::Triplet<double> > triplets;
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			auto e = testFEA.getElements()[i];
+			aeDense.col(i) = e->getStressSensitivityTermAE(freeDOFs, 0.1);
+			Eigen::VectorXd aeI = e->getElementStressSensitivityTermAE(0.1);
+			for (unsigned int j = 0; j < e->getEFT().size(); ++j)
+			{
+				if (e->getEFT()[j] >= 0) triplets.push_back(Eigen::Triplet<double>(e->getEFT()[j], i, aeI(j)));
+			}
+		}
+		Eigen::SparseMatrix<double> aeSparse(freeDOFs,2);
+		aeSparse.setFromTriplets(triplets.begin(), triplets.end());
+		BOOST_REQUIRE((Eigen::MatrixXd(aeSparse) - aeDense).norm() == 0.0);
+		BOOST_REQUIRE(aeDense.norm() > 0);
+
+		Eigen::MatrixXd lambdaDense = testFEA.solveAdjoint(aeDense);
+		Eigen::MatrixXd lambdaSparse = testFEA.solveAdjoint(aeSparse);
+		BOOST_REQUIRE((lambdaDense - lambdaSparse).norm() <= 1e-12 * lambdaDense.norm());
+	}
+
+	BOOST_AUTO_TEST_CASE( solve_realizations )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1000,0,0});
+		element::node* n3 = testFEA.addNode({1000,1000,0});
+		element::node* n4 = testFEA.addNode({0,1000,0});
+		element::node* n5 = testFEA.addNode({2000,0,0});
+		element::node* n6 = testFEA.addNode({2000,1000,0});
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			n1->addConstraint(i);
+			n4->addConstraint(i);
+		}
+		for (auto& i : {n2,n3,n5,n6}) i->addConstraint(2);
+		element::load_case lc1("test_case");
+		n6->addLoad(element::load(lc1,-1e3,1));
+		testFEA.addElement(new element::flat_shell(0,1e5,50,0.3,{n1,n2,n3,n4}));
+		testFEA.addElement(new element::flat_shell(1,1e5,50,0.3,{n2,n5,n6,n3}));
+		testFEA.setParallel(true, 2);
+
+		// a realization with the stiffness factors of the elements equals the solve,
+		// scaling all stiffness factors scales the displacements inversely
+		std::vector<Eigen::MatrixXd> displacements;
+		testFEA.solveRealizations({Eigen::VectorXd::Ones(2), Eigen::VectorXd::Constant(2,0.5),
+			Eigen::VectorXd::Constant(2,0.25)}, displacements);
+		testFEA.generateGSM();
+		testFEA.solve();
+		const Eigen::MatrixXd& u = testFEA.getDisplacements();
+		BOOST_REQUIRE(displacements.size() == 3 && u.norm() > 0);
+		BOOST_REQUIRE((displacements[0] - u).norm() <= 1e-12 * u.norm());
+		BOOST_REQUIRE((displacements[1] - 2*u).norm() <= 1e-12 * u.norm());
+		BOOST_REQUIRE((displacements[2] - 4*u).norm() <= 1e-12 * u.norm());
+
+		// the elements keep their own stiffness, a single realization is solved in place on the GSM
+		Eigen::SparseMatrix<double> GSM = testFEA.getGSM();
+		testFEA.solveRealizations({Eigen::VectorXd::Constant(2,0.5)}, displacements);
+		BOOST_REQUIRE(displacements.size() == 1);
+		BOOST_REQUIRE((displacements[0] - 2*u).norm() <= 1e-12 * u.norm());
+		BOOST_REQUIRE(testFEA.getElements()[0]->getStiffnessFactor() == 1.0);
+		BOOST_REQUIRE((testFEA.getGSM() - 0.5*GSM).norm() <= 1e-14 * GSM.norm());
+
+		// the displacements of a realization become the response of the elements
+		double energy = testFEA.getElements()[1]->getTotalEnergy();
+		testFEA.setDisplacements(displacements[0]);
+		BOOST_REQUIRE(energy > 0 && std::abs(testFEA.getElements()[1]->getTotalEnergy() - 4*energy) <= 1e-10 * energy);
+		BOOST_REQUIRE_THROW(testFEA.setDisplacements(Eigen::MatrixXd::Zero(3,1)), std::invalid_argument);
+
+		BOOST_REQUIRE_THROW(testFEA.solveRealizations({Eigen::VectorXd::Ones(3)}, displacements), std::invalid_argument);
+		BOOST_REQUIRE_THROW(testFEA.solveRealizations({Eigen::VectorXd::Ones(2)}, displacements, "PCG"), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( solve_PCG )
+	{
+		fea testFEA;
+		std::vector<element::node*> nodes;
+		for (unsigned int i = 0; i < 5; ++i)
+		{
+			for (unsigned int j = 0; j < 5; ++j) nodes.push_back(testFEA.addNode({250.0*i,250.0*j,0}));
+		}
+		for (unsigned int i = 0; i < 5; ++i)
+		{
+			for (unsigned int j = 0; j < 6; ++j) nodes[i]->addConstraint(j);
+		}
+		element::load_case lc1("test_case_1"), lc2("test_case_2");
+		nodes[24]->addLoad(element::load(lc1,-1e3,2));
+		nodes[22]->addLoad(element::load(lc2,1e3,1));
+		unsigned long ID = 0;
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			for (unsigned int j = 0; j < 4; ++j)
+			{
+				testFEA.addElement(new element::flat_shell(ID++,1e5,50,0.3,{nodes[5*i+j],
+					nodes[5*(i+1)+j],nodes[5*(i+1)+j+1],nodes[5*i+j+1]}));
+			}
+		}
+		testFEA.generateGSM();
+		testFEA.solve("SimplicialLDLT");
+		Eigen::MatrixXd check = testFEA.getDisplacements();
+		
+		testFEA.setPCGTolerance(1e-10);
+		testFEA.solve("PCG");
+		BOOST_REQUIRE((testFEA.getDisplacements() - check).norm() < 1e-6 * check.norm());
+		unsigned long coldIterations = testFEA.getPCGIterations();
+		
+		// a slightly changed system converges faster from the previous solution
+		for (auto& i : testFEA.getElements()) i->updateDensity(0.99);
+		testFEA.generateGSM();
+		testFEA.solve("SimplicialLDLT");
+		check = testFEA.getDisplacements();
+		testFEA.solve("PCG");
+		BOOST_REQUIRE((testFEA.getDisplacements() - check).norm() < 1e-6 * check.norm());
+		BOOST_REQUIRE(testFEA.getPCGIterations() < coldIterations);
+	}
+
+	BOOST_AUTO_TEST_CASE( singularity )
+	{
+		fea testFEA;
+		element::node* n1 = testFEA.addNode({0,0,0});
+		element::node* n2 = testFEA.addNode({1000,0,0});
+		element::node* n3 = testFEA.addNode({1000,1000,0});
+		element::node* n4 = testFEA.addNode({0,1000,0});
+		for (unsigned int i = 0; i < 6; ++i) n1->addConstraint(i);
+		n2->addConstraint(1);
+		n2->addConstraint(2);
+		n4->addConstraint(2);
+		testFEA.addElement(new element::flat_shell(0,1e5,50,0.3,{n1,n2,n3,n4}));
+		testFEA.generateGSM();
+		
+		// the estimate must agree with the condition number of a dense SVD
+		Eigen::JacobiSVD<Eigen::MatrixXd> SVD(Eigen::MatrixXd(testFEA.getGSM()));
+		double cond = SVD.singularValues()(0) / SVD.singularValues()(SVD.singularValues().size()-1);
+		BOOST_REQUIRE(abs(testFEA.estimateConditionNumber()/cond-1) < 1e-2);
+		BOOST_REQUIRE(!testFEA.isSingular());
+		
+		// a truss that can rotate freely about its axis is a mechanism
+		fea mechanismFEA;
+		n1 = mechanismFEA.addNode({0,0,0});
+		n2 = mechanismFEA.addNode({1000,0,0});
+		for (unsigned int i = 0; i < 3; ++i) n1->addConstraint(i);
+		mechanismFEA.addElement(new element::truss(0,1e5,1e3,{n1,n2}));
+		mechanismFEA.generateGSM();
+		BOOST_REQUIRE(mechanismFEA.isSingular());
+		
+		fea emptyFEA;
+		emptyFEA.generateGSM();
+		BOOST_REQUIRE(emptyFEA.isSingular());
+	}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace structural_design_test
\ No newline at end of file
@@ -192,7 +192,54 @@ BOOST_AUTO_TEST_SUITE( sd_analysis_test )
 
 		BOOST_REQUIRE(checkDisp.isApprox(checkNode->getDisplacements(lc1),1e-4));
 	}
-	
+
+	BOOST_AUTO_TEST_CASE( partial_results )
+	{
+		sd_model sd1;
+		namespace geom = bso::utilities::geometry;
+
+		auto p1 = sd1.addPoint({0,0,0});
+		auto p2 = sd1.addPoint({3500,0,0});
+		for (unsigned int i = 0; i < 6; ++i)
+		{
+			component::constraint c(i);
+			p1->addConstraint(c);
+		}
+		component::load_case lc1("vertical load");
+		component::load l1(lc1,-200,2);
+		p2->addLoad(l1);
+		auto geom1 = sd1.addGeometry(geom::line_segment({*p1,*p2}));
+		component::structure str1("beam",{{"E",1e5},{"width",100},{"height",400},{"poisson",0.3}});
+		geom1->addStructure(str1);
+		sd1.mesh(10);
+		sd1.analyze();
+
+		geom::quad_hexahedron left  = {{   0,-100,-100},{   0,-100,100},{   0,100,-100},{   0,100,100},
+																	 {1750, 100, 100},{1750, 100,-100},{1750,-100,100},{1750,-100,-100}};
+		geom::quad_hexahedron right = {{1750,-100,-100},{1750,-100,100},{1750,100,-100},{1750,100,100},
+																	 {3500, 100, 100},{3500, 100,-100},{3500,-100,100},{3500,-100,-100}};
+		geom::quad_hexahedron away  = {{5000,-100,-100},{5000,-100,100},{5000,100,-100},{5000,100,100},
+																	 {6000, 100, 100},{6000, 100,-100},{6000,-100,100},{6000,-100,-100}};
+
+		auto total = sd1.getTotalResults();
+		auto resultLeft = sd1.getPartialResults(&left);
+		auto resultRight = sd1.getPartialResults(&right);
+		BOOST_REQUIRE(resultLeft.mTotalStrainEnergy > resultRight.mTotalStrainEnergy);
+		BOOST_REQUIRE(std::abs(resultLeft.mTotalStrainEnergy + resultRight.mTotalStrainEnergy
+			- total.mTotalStrainEnergy) < 1e-12*total.mTotalStrainEnergy);
+		BOOST_REQUIRE(std::abs(resultLeft.mTotalStructuralVolume + resultRight.mTotalStructuralVolume
+			- total.mTotalStructuralVolume) < 1e-12*total.mTotalStructuralVolume);
+
+		// the batch gives the same results as separate queries
+		auto results = sd1.getPartialResults({&left,&right,&away});
+		BOOST_REQUIRE(results.size() == 3);
+		BOOST_REQUIRE(results[0].mTotalStrainEnergy == resultLeft.mTotalStrainEnergy);
+		BOOST_REQUIRE(results[1].mTotalStrainEnergy == resultRight.mTotalStrainEnergy);
+		BOOST_REQUIRE(results[1].mTotalStructuralVolume == resultRight.mTotalStructuralVolume);
+		BOOST_REQUIRE(results[2].mTotalStrainEnergy == 0.0);
+		BOOST_REQUIRE(results[2].mTotalStructuralVolume == 0.0);
+	}
+
 	BOOST_AUTO_TEST_CASE( topopt_SIMP )
 	{ // benchmarked with 88-line matlab code from DTU
 		sd_model sd1;
@@ -240,6 +287,138 @@ BOOST_AUTO_TEST_SUITE( sd_analysis_test )
 		}
 		BOOST_REQUIRE(abs(compliance/101.5963 - 1) < 1e-5);
 	}
+
+	BOOST_AUTO_TEST_CASE( topopt_ROBUST )
+	{ // pinned to the results of ROBUST before its realizations were solved by the optimization driver
+		namespace geom = bso::utilities::geometry;
+		component::constraint c0(0), c1(1), c2(2), c3(3), c4(4);
+		component::load_case lc1("vertical load");
+		component::load l1(lc1, 1,1);
+		component::structure str1("flat_shell",{{"E",1},{"thickness",1},{"poisson",0.3}});
+		std::stringstream out; // the tables of iterations
+		auto createModel = [&](sd_model& sd)
+		{
+			auto p1 = sd.addPoint({0,20,0});
+			auto p2 = sd.addPoint({60,0,0});
+			p2->addConstraint(c1);
+			p1->addLoad(l1);
+			auto line1 = sd.addGeometry(geom::line_segment({{0,0,0},{0,20,0}}));
+			line1->addConstraint(c0);
+			for (auto& i : {sd.addGeometry(geom::quadrilateral({{0,0,0},{0,20,0},{20,20,0},{20,0,0}})),
+											sd.addGeometry(geom::quadrilateral({{20,0,0},{20,20,0},{40,20,0},{40,0,0}})),
+											sd.addGeometry(geom::quadrilateral({{40,0,0},{40,20,0},{60,20,0},{60,0,0}}))})
+			{
+				i->addStructure(str1);
+				i->addConstraint(c2); i->addConstraint(c3); i->addConstraint(c4);
+			}
+			sd.mesh(6);
+			sd.setTopOptOutputStream(out);
+		};
+		auto energies = [](sd_model& sd)
+		{
+			std::vector<double> result;
+			for (const auto& i : sd.getFEA()->getElements()) result.push_back(i->getTotalEnergy());
+			return result;
+		};
+		auto densitySum = [](sd_model& sd)
+		{
+			double sum = 0;
+			for (const auto& i : sd.getFEA()->getElements()) sum += i->getDensity();
+			return sum;
+		};
+
+		// the elements get the response of the eroded design and the densities of the nominal design
+		sd_model sd1;
+		createModel(sd1);
+		sd1.topologyOptimization<topology_optimization::ROBUST>(0.5,1.5,3.0,0.2,1e-2);
+		std::vector<double> e1 = energies(sd1);
+		double compliance = 0, squaredEnergies = 0;
+		for (const auto& i : e1)
+		{
+			compliance += i;
+			squaredEnergies += i*i;
+		}
+		BOOST_REQUIRE(abs(compliance/99.8119633049 - 1) < 1e-8);
+		BOOST_REQUIRE(abs(squaredEnergies/340.858885632 - 1) < 1e-8);
+		BOOST_REQUIRE(abs(*std::max_element(e1.begin(), e1.end())/7.12897904886 - 1) < 1e-8);
+		BOOST_REQUIRE(abs(e1[0]/5.85885904234 - 1) < 1e-8);
+		BOOST_REQUIRE(abs(densitySum(sd1)/54 - 1) < 1e-8);
+
+		// with fixed loads the eroded design is the worst realization, so the min-max
+		// formulation follows the same path, one iteration for each beta
+		sd_model sd2, sd3;
+		createModel(sd2);
+		createModel(sd3);
+		sd3.setRobustMinMax();
+		sd2.topologyOptimization<topology_optimization::ROBUST>(0.5,1.5,3.0,0.2,0.5);
+		sd3.topologyOptimization<topology_optimization::ROBUST>(0.5,1.5,3.0,0.2,0.5);
+		std::vector<double> e2 = energies(sd2), e3 = energies(sd3);
+		for (unsigned int i = 0; i < e2.size(); ++i)
+		{
+			BOOST_REQUIRE(abs(e3[i] - e2[i]) <= 1e-10 * abs(e2[i]));
+		}
+		BOOST_REQUIRE(abs(densitySum(sd3)/densitySum(sd2) - 1) < 1e-12);
+
+		// without iterations the elements get the nominal design of the initial densities
+		sd_model sd4;
+		createModel(sd4);
+		sd4.setRobustMinMax();
+		BOOST_REQUIRE_NO_THROW(sd4.topologyOptimization<topology_optimization::ROBUST>(0.5,1.5,3.0,0.2,1.0));
+		BOOST_REQUIRE(abs(densitySum(sd4)/54 - 1) < 1e-12);
+	}
+
+	BOOST_AUTO_TEST_CASE( mesh_hierarchy )
+	{
+		namespace geom = bso::utilities::geometry;
+		component::constraint c0(0), c1(1), c2(2), c3(3), c4(4);
+		component::load_case lc1("vertical load");
+		component::load l1(lc1, 1,1);
+		component::structure str1("flat_shell",{{"E",1},{"thickness",1},{"poisson",0.3}});
+		auto createModel = [&](sd_model& sd)
+		{
+			auto p1 = sd.addPoint({0,20,0});
+			auto p2 = sd.addPoint({40,0,0});
+			p2->addConstraint(c1);
+			p1->addLoad(l1);
+			auto line1 = sd.addGeometry(geom::line_segment({{0,0,0},{0,20,0}}));
+			line1->addConstraint(c0);
+			for (auto& i : {sd.addGeometry(geom::quadrilateral({{0,0,0},{0,20,0},{20,20,0},{20,0,0}})),
+											sd.addGeometry(geom::quadrilateral({{20,0,0},{20,20,0},{40,20,0},{40,0,0}}))})
+			{
+				i->addStructure(str1);
+				i->addConstraint(c2); i->addConstraint(c3); i->addConstraint(c4);
+			}
+		};
+
+		sd_model sd1, sd3, sd6;
+		createModel(sd1); createModel(sd3); createModel(sd6);
+		sd1.setMultigridLevels(4); // 12 can be halved twice to 3, and not three times
+		sd1.mesh(12);
+		sd3.mesh(3);
+		sd6.mesh(6);
+		const auto& hierarchy = sd1.getFEA()->getMeshHierarchy();
+		BOOST_REQUIRE(hierarchy.size() == 2);
+		BOOST_REQUIRE(hierarchy[0].mProlongation.rows() == (long)sd1.getFEA()->getNodes().size());
+		BOOST_REQUIRE(hierarchy[0].mCoarseNodes.size() == sd6.getFEA()->getNodes().size());
+		BOOST_REQUIRE(hierarchy[1].mCoarseNodes.size() == sd3.getFEA()->getNodes().size());
+		for (const auto& i : hierarchy)
+		{ // interpolation reproduces constant displacements
+			Eigen::VectorXd rowSums = i.mProlongation * Eigen::VectorXd::Ones(i.mProlongation.cols());
+			BOOST_REQUIRE((rowSums.array() - 1.0).abs().maxCoeff() < 1e-15);
+		}
+
+		sd1.analyze("SimplicialLDLT");
+		Eigen::MatrixXd uDirect = sd1.getFEA()->getDisplacements();
+		sd1.getFEA()->setPCGTolerance(1e-10);
+		sd1.analyze("MGCG");
+		Eigen::MatrixXd uMGCG = sd1.getFEA()->getDisplacements();
+		BOOST_REQUIRE((uMGCG - uDirect).norm() <= 1e-8 * uDirect.norm());
+		BOOST_REQUIRE(sd1.getFEA()->getPCGIterations() < 20);
+
+		BOOST_REQUIRE(sd6.getFEA()->getMeshHierarchy().empty());
+		BOOST_REQUIRE_THROW(sd6.analyze("MGCG"), std::runtime_error);
+		BOOST_REQUIRE_THROW(sd6.setMultigridLevels(0), std::invalid_argument);
+	}
 	
 	
 BOOST_AUTO_TEST_SUITE_END()
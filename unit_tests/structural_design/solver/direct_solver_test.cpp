@@ -0,0 +1,85 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_direct_solver"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/solver/direct_solver.hpp>
+
+#include <memory>
+#include <stdexcept>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace solver_test {
+using namespace bso::structural_design::solver;
+
+BOOST_AUTO_TEST_SUITE( sd_direct_solver )
+	
+	BOOST_AUTO_TEST_CASE( create )
+	{
+		BOOST_REQUIRE(is_direct_solver("SimplicialLDLT"));
+		BOOST_REQUIRE(is_direct_solver("CholmodSupernodalLLT"));
+		BOOST_REQUIRE(!is_direct_solver("BiCGSTAB"));
+		BOOST_REQUIRE_THROW(create_direct_solver("BiCGSTAB"), std::invalid_argument);
+		
+		std::unique_ptr<direct_solver> s1(create_direct_solver("SimplicialLLT"));
+		BOOST_REQUIRE(s1->backendName() == "SimplicialLLT");
+		
+		BOOST_REQUIRE(is_available("SimplicialLLT") && is_available("SimplicialLDLT"));
+		BOOST_REQUIRE(!is_available("BiCGSTAB"));
+#ifdef BSO_USE_CHOLMOD
+		BOOST_REQUIRE(is_available("CholmodSupernodalLLT"));
+#else
+		BOOST_REQUIRE(!is_available("CholmodSupernodalLLT"));
+#endif
+#ifdef BSO_USE_PARDISO
+		BOOST_REQUIRE(is_available("PardisoLLT") && is_available("PardisoLDLT"));
+#else
+		BOOST_REQUIRE(!is_available("PardisoLLT") && !is_available("PardisoLDLT"));
+#endif
+		
+		// an unavailable backend is replaced by SimplicialLDLT
+		for (std::string name : {"CholmodSupernodalLLT", "PardisoLLT", "PardisoLDLT"})
+		{
+			std::unique_ptr<direct_solver> s2(create_direct_solver(name));
+			BOOST_REQUIRE(s2->backendName() == (is_available(name) ? name : "SimplicialLDLT"));
+		}
+	}
+	
+	BOOST_AUTO_TEST_CASE( solve )
+	{
+		Eigen::SparseMatrix<double> A(3,3);
+		std::vector<Eigen::Triplet<double> > triplets = {
+			{0,0,4}, {0,1,1}, {1,0,1}, {1,1,3}, {1,2,1}, {2,1,1}, {2,2,2}};
+		A.setFromTriplets(triplets.begin(), triplets.end());
+		Eigen::MatrixXd B(3,2);
+		B << 1, 0,
+		     2, 1,
+		     3, 0;
+		
+		for (std::string name : {"SimplicialLLT", "SimplicialLDLT", "CholmodSupernodalLLT",
+														 "PardisoLLT", "PardisoLDLT"})
+		{
+			if (!is_available(name))
+			{
+				BOOST_TEST_MESSAGE("direct solver " << name << " is not compiled in, skipped");
+				continue;
+			}
+			std::unique_ptr<direct_solver> s1(create_direct_solver(name));
+			BOOST_REQUIRE(s1->backendName() == name);
+			s1->analyzePattern(A);
+			s1->factorize(A);
+			BOOST_REQUIRE(s1->info() == Eigen::Success);
+			Eigen::MatrixXd X = s1->solve(B);
+			BOOST_REQUIRE((A*X - B).norm() < 1e-12);
+		}
+	}
+	
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace solver_test
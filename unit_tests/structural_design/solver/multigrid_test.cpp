@@ -0,0 +1,81 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_multigrid"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/solver/multigrid.hpp>
+
+#include <stdexcept>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace solver_test {
+using namespace bso::structural_design::solver;
+
+BOOST_AUTO_TEST_SUITE( sd_multigrid )
+
+	Eigen::SparseMatrix<double> laplacian(const unsigned int& n)
+	{ // 1D Laplacian with fixed ends
+		std::vector<Eigen::Triplet<double> > triplets;
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			triplets.push_back({(int)i,(int)i,2.0});
+			if (i > 0) triplets.push_back({(int)i,(int)i-1,-1.0});
+			if (i+1 < n) triplets.push_back({(int)i,(int)i+1,-1.0});
+		}
+		Eigen::SparseMatrix<double> A(n,n);
+		A.setFromTriplets(triplets.begin(), triplets.end());
+		return A;
+	}
+
+	Eigen::SparseMatrix<double> interpolation(const unsigned int& coarseCount)
+	{ // linear interpolation of coarseCount interior points to 2*coarseCount+1
+		std::vector<Eigen::Triplet<double> > triplets;
+		for (unsigned int i = 0; i < coarseCount; ++i)
+		{
+			triplets.push_back({(int)(2*i+1),(int)i,1.0});
+			triplets.push_back({(int)(2*i),(int)i,0.5});
+			triplets.push_back({(int)(2*i+2),(int)i,0.5});
+		}
+		Eigen::SparseMatrix<double> P(2*coarseCount+1,coarseCount);
+		P.setFromTriplets(triplets.begin(), triplets.end());
+		return P;
+	}
+
+	BOOST_AUTO_TEST_CASE( preconditioned_cg )
+	{
+		Eigen::SparseMatrix<double> A = laplacian(255);
+		Eigen::VectorXd b = Eigen::VectorXd::Ones(255);
+
+		Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower|Eigen::Upper,
+			multigrid_preconditioner> cg;
+		cg.preconditioner().setProlongations({interpolation(127), interpolation(63), interpolation(31)});
+		cg.setTolerance(1e-10);
+		cg.compute(A);
+		BOOST_REQUIRE(cg.info() == Eigen::Success);
+		BOOST_REQUIRE(cg.preconditioner().levelCount() == 4);
+		BOOST_REQUIRE(cg.preconditioner().getOperator(3).rows() == 31);
+		Eigen::VectorXd x = cg.solve(b);
+		BOOST_REQUIRE(cg.info() == Eigen::Success);
+		BOOST_REQUIRE((A*x - b).norm() <= 1e-9 * b.norm());
+		BOOST_REQUIRE(cg.iterations() < 15);
+
+		// without prolongations the preconditioner is a direct solve
+		multigrid_preconditioner direct(A);
+		BOOST_REQUIRE(direct.levelCount() == 1);
+		BOOST_REQUIRE((A*direct.solve(b) - b).norm() <= 1e-9 * b.norm());
+
+		multigrid_preconditioner mg;
+		BOOST_REQUIRE_THROW(mg.setProlongations({interpolation(127), interpolation(31)}), std::invalid_argument);
+		mg.setProlongations({interpolation(63)});
+		BOOST_REQUIRE_THROW(mg.compute(A), std::invalid_argument);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace solver_test
@@ -0,0 +1,118 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_density_filter"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/topology_optimization/density_filter.hpp>
+
+#include <random>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace topology_optimization_test {
+using namespace bso::structural_design::topology_optimization;
+
+BOOST_AUTO_TEST_SUITE( sd_density_filter_test )
+
+	BOOST_AUTO_TEST_CASE( grid_of_centers )
+	{
+		Eigen::Matrix3Xd centers(3,4);
+		centers << 0, 1, 2, 0,
+		           0, 0, 0, 1,
+		           0, 0, 0, 0;
+		Eigen::SparseMatrix<double> H;
+		Eigen::VectorXd Hs;
+		build_density_filter(centers,1.5,H,Hs);
+		BOOST_REQUIRE(H.rows() == 4 && H.cols() == 4);
+		BOOST_REQUIRE(H.nonZeros() == 12); // all pairs except (2,3) and (3,2)
+		BOOST_REQUIRE(H.coeff(0,0) == 1.5);
+		BOOST_REQUIRE(H.coeff(0,1) == 0.5);
+		BOOST_REQUIRE(H.coeff(2,3) == 0.0);
+		BOOST_REQUIRE(std::abs(H.coeff(1,3) - (1.5 - std::sqrt(2.0))) < 1e-15);
+		BOOST_REQUIRE(Hs(2) == 2.0);
+		BOOST_REQUIRE_THROW(build_density_filter(centers,0.0,H,Hs), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( same_as_all_pairs )
+	{
+		std::mt19937 randomGenerator(0);
+		std::uniform_real_distribution<double> distribution(0.0,10.0);
+		unsigned long numEle = 500;
+		double rMin = 1.5;
+		Eigen::Matrix3Xd centers(3,numEle);
+		for (unsigned long i = 0; i < numEle; ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j) centers(j,i) = distribution(randomGenerator);
+		}
+
+		Eigen::SparseMatrix<double> checkH(numEle,numEle);
+		Eigen::VectorXd checkHs = Eigen::VectorXd::Zero(numEle);
+		std::vector<Eigen::Triplet<double> > triplets;
+		for (unsigned long i = 0; i < numEle; ++i)
+		{
+			for (unsigned long j = 0; j < numEle; ++j)
+			{
+				double rij = (centers.col(j) - centers.col(i)).norm();
+				if (rij < rMin)
+				{
+					triplets.push_back(Eigen::Triplet<double>(i,j,rMin - rij));
+					checkHs(i) += rMin - rij;
+				}
+			}
+		}
+		checkH.setFromTriplets(triplets.begin(), triplets.end());
+
+		for (unsigned int threadCount : {1, 3})
+		{
+			Eigen::SparseMatrix<double> H;
+			Eigen::VectorXd Hs;
+			build_density_filter(centers,rMin,H,Hs,threadCount);
+			BOOST_REQUIRE(H.nonZeros() == checkH.nonZeros());
+			BOOST_REQUIRE((H - checkH).norm() == 0.0);
+			BOOST_REQUIRE(Hs == checkHs);
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( groups_share_the_neighbour_search )
+	{
+		std::mt19937 randomGenerator(1);
+		std::uniform_real_distribution<double> distribution(0.0,5.0);
+		unsigned long numEle = 200;
+		double rMin = 1.2;
+		Eigen::Matrix3Xd centers(3,numEle);
+		std::vector<unsigned int> groups(numEle);
+		std::vector<std::vector<unsigned long> > members(3);
+		for (unsigned long i = 0; i < numEle; ++i)
+		{
+			for (unsigned int j = 0; j < 3; ++j) centers(j,i) = distribution(randomGenerator);
+			groups[i] = (i*7)%3;
+			members[groups[i]].push_back(i);
+		}
+
+		std::vector<Eigen::SparseMatrix<double> > H;
+		std::vector<Eigen::VectorXd> Hs;
+		build_density_filters(centers,groups,rMin,H,Hs,2);
+		BOOST_REQUIRE(H.size() == 3 && Hs.size() == 3);
+		for (unsigned int k = 0; k < 3; ++k)
+		{ // each group equals the filter of only the elements of that group
+			Eigen::Matrix3Xd groupCenters(3,members[k].size());
+			for (unsigned long i = 0; i < members[k].size(); ++i) groupCenters.col(i) = centers.col(members[k][i]);
+			Eigen::SparseMatrix<double> checkH;
+			Eigen::VectorXd checkHs;
+			build_density_filter(groupCenters,rMin,checkH,checkHs);
+			BOOST_REQUIRE(H[k].rows() == checkH.rows() && H[k].nonZeros() == checkH.nonZeros());
+			BOOST_REQUIRE((H[k] - checkH).norm() == 0.0);
+			BOOST_REQUIRE(Hs[k] == checkHs);
+		}
+		BOOST_REQUIRE_THROW(build_density_filters(centers,std::vector<unsigned int>(3,0),rMin,H,Hs),
+			std::invalid_argument);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace topology_optimization_test
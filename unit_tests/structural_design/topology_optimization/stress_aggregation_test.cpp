@@ -0,0 +1,90 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_stress_aggregation"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/topology_optimization/stress_aggregation.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace topology_optimization_test {
+using namespace bso::structural_design::topology_optimization;
+
+BOOST_AUTO_TEST_SUITE( sd_stress_aggregation_test )
+
+	BOOST_AUTO_TEST_CASE( stress_level_clusters )
+	{
+		Eigen::VectorXd s(5);
+		s << 0.2, 0.9, -0.5, 0.4, 0.7;
+		stress_aggregation agg(stress_aggregation::P_NORM, 8.0, 2);
+		agg.compute(s);
+		BOOST_REQUIRE(agg.getClusters().size() == 2);
+		std::vector<unsigned long> first = {1, 4}, second = {3, 0, 2};
+		BOOST_REQUIRE(agg.getClusters()[0] == first);
+		BOOST_REQUIRE(agg.getClusters()[1] == second);
+		BOOST_REQUIRE(agg.getWeights().rows() == 2 && agg.getWeights().cols() == 5);
+		BOOST_REQUIRE(agg.getWeights().coeff(1,2) == 0.0); // negative stresses are ignored by the p-norm
+
+		stress_aggregation many(stress_aggregation::KS, 10.0, 20);
+		BOOST_REQUIRE(many.getClusterCount(5) == 5);
+		BOOST_REQUIRE_THROW(stress_aggregation(stress_aggregation::P_NORM, 0.5, 1), std::invalid_argument);
+		BOOST_REQUIRE_THROW(stress_aggregation(stress_aggregation::KS, 10.0, 0), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( bounds_and_derivatives )
+	{
+		Eigen::VectorXd s(6);
+		s << 0.3, 0.95, 0.1, 0.6, -0.2, 0.8;
+		for (const auto& type : {stress_aggregation::P_NORM, stress_aggregation::KS})
+		{
+			stress_aggregation agg(type, 8.0, 2, false);
+			agg.compute(s);
+			Eigen::VectorXd values = agg.getValues();
+			Eigen::MatrixXd weights = agg.getWeights();
+			for (unsigned int k = 0; k < 2; ++k)
+			{
+				double maxStress = s(agg.getClusters()[k].front());
+				BOOST_REQUIRE(values(k) >= maxStress);
+			}
+			
+			// central differences, the perturbation keeps the clusters the same
+			double h = 1e-6;
+			for (unsigned int e = 0; e < 6; ++e)
+			{
+				if (s(e) < 0) continue;
+				Eigen::VectorXd sp = s, sm = s;
+				sp(e) += h; sm(e) -= h;
+				agg.compute(sp);
+				Eigen::VectorXd vp = agg.getValues();
+				agg.compute(sm);
+				Eigen::VectorXd vm = agg.getValues();
+				for (unsigned int k = 0; k < 2; ++k)
+				{
+					BOOST_REQUIRE(std::abs((vp(k) - vm(k))/(2*h) - weights(k,e)) < 1e-6);
+				}
+			}
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( adaptive_normalization )
+	{
+		Eigen::VectorXd s(4);
+		s << 0.5, 0.9, 0.8, 0.7;
+		stress_aggregation agg(stress_aggregation::P_NORM, 8.0, 1, true);
+		agg.compute(s);
+		double unscaled = agg.getValues()(0); // the first call is not scaled
+		BOOST_REQUIRE(unscaled > 0.9);
+		BOOST_REQUIRE(std::abs(agg.getNormalization()(0) - 0.9/unscaled) < 1e-15);
+		agg.compute(s); // the same stresses: the aggregate equals the largest stress
+		BOOST_REQUIRE(std::abs(agg.getValues()(0) - 0.9) < 1e-12);
+		BOOST_REQUIRE(std::abs(agg.getWeights().coeff(0,1) - agg.getNormalization()(0)*std::pow(0.9/unscaled,7)) < 1e-12);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace topology_optimization_test
@@ -0,0 +1,88 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE "sd_update_schemes"
+#endif
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <bso/structural_design/topology_optimization/update_schemes.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace topology_optimization_test {
+using namespace bso::structural_design::topology_optimization;
+
+BOOST_AUTO_TEST_SUITE( sd_update_schemes_test )
+
+	BOOST_AUTO_TEST_CASE( optimality_criteria_volume )
+	{
+		Eigen::VectorXd x(4), xNew, dc(4), dv(4), volume(4);
+		x << 0.5, 0.5, 0.5, 0.5;
+		dc << -4.0, -2.0, -1.0, -0.5;
+		volume << 1.0, 1.0, 2.0, 2.0;
+		dv = volume;
+		optimality_criteria OC(0.2);
+		OC.update(x, xNew, dc, dv, volume, 0.5*volume.sum());
+		BOOST_REQUIRE(xNew.size() == 4);
+		BOOST_REQUIRE(std::abs(volume.dot(xNew) - 0.5*volume.sum()) < 1e-2);
+		BOOST_REQUIRE(xNew(0) >= xNew(1) && xNew(1) >= xNew(2) && xNew(2) >= xNew(3));
+		BOOST_REQUIRE((xNew - x).cwiseAbs().maxCoeff() <= 0.2 + 1e-12);
+
+		// a physical volume that doubles the design variables halves the result
+		Eigen::VectorXd xNew2;
+		OC.update(x, xNew2, dc, dv, 0.5*volume.sum(),
+			[&volume](const Eigen::VectorXd& xDesign) {return 2.0*volume.dot(xDesign);});
+		BOOST_REQUIRE(volume.dot(xNew2) < volume.dot(xNew));
+	}
+
+	BOOST_AUTO_TEST_CASE( heaviside_projection_values )
+	{
+		heaviside_projection p(8.0, 0.5);
+		BOOST_REQUIRE(std::abs(p.project(0.0)) < 1e-12);
+		BOOST_REQUIRE(std::abs(p.project(1.0) - 1.0) < 1e-12);
+		BOOST_REQUIRE(std::abs(p.project(0.5) - 0.5) < 1e-12);
+		double h = 1e-6;
+		BOOST_REQUIRE(std::abs(p.derivative(0.3) - (p.project(0.3+h) - p.project(0.3-h))/(2*h)) < 1e-6);
+		p.setBeta(16.0);
+		BOOST_REQUIRE(p.getBeta() == 16.0 && p.getEta() == 0.5);
+	}
+
+	BOOST_AUTO_TEST_CASE( heaviside_projection_kernels )
+	{
+		Eigen::VectorXd x = (Eigen::VectorXd::Random(1000).array() + 1.0) / 2.0;
+		heaviside_projection eroded(8.0, 0.8), nominal(8.0, 0.5), dilated(8.0, 0.2);
+		Eigen::VectorXd xe, xn, xd, dxe, dxd;
+		heaviside_project(x, 8.0, {0.8, 0.5, 0.2}, {&xe, &xn, &xd}, {&dxe, nullptr, &dxd});
+		BOOST_REQUIRE(xe.size() == 1000 && xn.size() == 1000 && xd.size() == 1000 && dxd.size() == 1000);
+		for (unsigned int i = 0; i < 1000; ++i)
+		{
+			BOOST_REQUIRE(std::abs(xe(i) - eroded.project(x(i))) < 1e-12);
+			BOOST_REQUIRE(std::abs(xn(i) - nominal.project(x(i))) < 1e-12);
+			BOOST_REQUIRE(std::abs(xd(i) - dilated.project(x(i))) < 1e-12);
+			BOOST_REQUIRE(std::abs(dxe(i) - eroded.derivative(x(i))) < 1e-12);
+			BOOST_REQUIRE(std::abs(dxd(i) - dilated.derivative(x(i))) < 1e-12);
+		}
+		Eigen::VectorXd xn2;
+		nominal.project(x, xn2);
+		BOOST_REQUIRE((xn2 - xn).cwiseAbs().maxCoeff() < 1e-15);
+		BOOST_REQUIRE_THROW(heaviside_project(x, 8.0, {0.8, 0.5}, {&xe}, {nullptr}), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( optimality_criteria_kernels )
+	{
+		Eigen::VectorXd x(3), dc(3), dv(3), lower, upper, xNew;
+		x << 0.05, 0.5, 0.95;
+		dc << -1.0, -1.0, -100.0;
+		dv << 1.0, 1.0, 1.0;
+		oc_move_bounds(x, 0.2, lower, upper);
+		BOOST_REQUIRE(lower(0) == 0.0 && std::abs(lower(1) - 0.3) < 1e-15 && upper(2) == 1.0);
+		oc_step(x, dc, dv, 4.0, lower, upper, xNew);
+		BOOST_REQUIRE(std::abs(xNew(0) - 0.025) < 1e-15 && std::abs(xNew(1) - 0.3) < 1e-15 && xNew(2) == 1.0);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace topology_optimization_test
@@ -0,0 +1,125 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE aabb_tree_test
+#endif
+
+#include <bso/utilities/aabb_tree.hpp>
+#include <bso/utilities/geometry/vertex.hpp>
+
+#include <stdexcept>
+
+#include <boost/test/included/unit_test.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace utilities_test {
+using namespace bso::utilities;
+using bso::utilities::geometry::vertex;
+
+BOOST_AUTO_TEST_SUITE( aabb_tree_tests )
+
+	BOOST_AUTO_TEST_CASE( initialization )
+	{
+		aabb_tree t1;
+		BOOST_REQUIRE(t1.size() == 0);
+		BOOST_REQUIRE(t1.nodeCount() == 0);
+		BOOST_REQUIRE_THROW(aabb_tree t2(0), std::invalid_argument);
+
+		Eigen::Matrix3Xd minCorners(3,2), maxCorners(3,1);
+		BOOST_REQUIRE_THROW(t1.build(minCorners,maxCorners), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( queries_match_linear_search )
+	{ // a grid of unit boxes, queried with boxes that cut through the grid
+		unsigned int n = 10;
+		Eigen::Matrix3Xd minCorners(3,n*n*n), maxCorners(3,n*n*n);
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			for (unsigned int j = 0; j < n; ++j)
+			{
+				for (unsigned int k = 0; k < n; ++k)
+				{
+					unsigned int index = (i*n + j)*n + k;
+					minCorners.col(index) << i, j, k;
+					maxCorners.col(index) << i+1, j+1, k+1;
+				}
+			}
+		}
+		aabb_tree t1(4);
+		t1.build(minCorners,maxCorners);
+		BOOST_REQUIRE(t1.size() == n*n*n);
+		BOOST_REQUIRE(t1.nodeCount() > 1);
+
+		std::vector<std::pair<Eigen::Vector3d,Eigen::Vector3d>> queries = {
+			{{0,0,0},{10,10,10}}, {{2,3,4},{5,5,5}}, {{2.5,3,4},{5,5.5,5}},
+			{{-1,-1,-1},{0.5,0.5,0.5}}, {{11,0,0},{12,1,1}}, {{9,9,9},{9,9,9}}};
+		for (const auto& q : queries)
+		{
+			std::vector<unsigned long> checkContained, checkIntersecting;
+			for (unsigned long i = 0; i < t1.size(); ++i)
+			{
+				if ((q.first.array() <= minCorners.col(i).array()).all() &&
+						(maxCorners.col(i).array() <= q.second.array()).all())
+				{
+					checkContained.push_back(i);
+				}
+				if ((q.first.array() <= maxCorners.col(i).array()).all() &&
+						(minCorners.col(i).array() <= q.second.array()).all())
+				{
+					checkIntersecting.push_back(i);
+				}
+			}
+			std::vector<unsigned long> contained, intersecting;
+			t1.findContainedIn(q.first,q.second,contained);
+			t1.findIntersecting(q.first,q.second,intersecting);
+			BOOST_CHECK_EQUAL_COLLECTIONS(contained.begin(), contained.end(),
+				checkContained.begin(), checkContained.end());
+			BOOST_CHECK_EQUAL_COLLECTIONS(intersecting.begin(), intersecting.end(),
+				checkIntersecting.begin(), checkIntersecting.end());
+		}
+		std::vector<unsigned long> items;
+		t1.findContainedIn({2,3,4},{5,5,5},items);
+		BOOST_REQUIRE(items.size() == 3*2*1);
+		t1.findIntersecting({9,9,9},{9,9,9},items);
+		BOOST_REQUIRE(items.size() == 8);
+	}
+
+	BOOST_AUTO_TEST_CASE( coinciding_boxes )
+	{ // boxes that cannot be split end up in a single leaf
+		Eigen::Matrix3Xd minCorners = Eigen::Matrix3Xd::Zero(3,20);
+		Eigen::Matrix3Xd maxCorners = Eigen::Matrix3Xd::Ones(3,20);
+		aabb_tree t1(2);
+		t1.build(minCorners,maxCorners);
+		BOOST_REQUIRE(t1.nodeCount() == 1);
+		std::vector<unsigned long> items;
+		t1.findContainedIn({0,0,0},{1,1,1},items);
+		BOOST_REQUIRE(items.size() == 20);
+		t1.findContainedIn({0,0,0},{1,1,0.5},items);
+		BOOST_REQUIRE(items.empty());
+	}
+
+	BOOST_AUTO_TEST_CASE( bounding_box_and_clear )
+	{
+		std::vector<vertex> vertices = {vertex({1,-2,3}), vertex({-1,4,0}), vertex({0,0,5})};
+		Eigen::Vector3d min, max;
+		bounding_box(vertices,min,max);
+		BOOST_REQUIRE(min == Eigen::Vector3d(-1,-2,0));
+		BOOST_REQUIRE(max == Eigen::Vector3d(1,4,5));
+
+		aabb_tree t1;
+		t1.build(min,max);
+		std::vector<unsigned long> items;
+		t1.findIntersecting({0,0,0},{0,0,0},items);
+		BOOST_REQUIRE(items.size() == 1);
+		t1.clear();
+		BOOST_REQUIRE(t1.size() == 0);
+		t1.findIntersecting({0,0,0},{0,0,0},items);
+		BOOST_REQUIRE(items.empty());
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace utilities_test
@@ -0,0 +1,58 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE parallel_for_test
+#endif
+
+#include <bso/utilities/parallel_for.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <boost/test/included/unit_test.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace utilities_test {
+using namespace bso::utilities;
+
+BOOST_AUTO_TEST_SUITE( parallel_for_tests )
+
+	BOOST_AUTO_TEST_CASE( visit_all_indices )
+	{
+		for (unsigned int threadCount : {0, 1, 3, 8, 200})
+		{
+			std::vector<int> visits(100,0);
+			parallel_for(0, visits.size(), threadCount, [&](const unsigned long& i)
+			{
+				visits[i] += 1;
+			});
+			for (const auto& i : visits) BOOST_REQUIRE(i == 1);
+		}
+	}
+
+	BOOST_AUTO_TEST_CASE( empty_range )
+	{
+		int calls = 0;
+		parallel_for(5, 5, 4, [&](const unsigned long&) {++calls;});
+		BOOST_REQUIRE(calls == 0);
+	}
+
+	BOOST_AUTO_TEST_CASE( rethrow_exception )
+	{
+		BOOST_REQUIRE_THROW(parallel_for(0, 10, 4, [](const unsigned long& i)
+		{
+			if (i == 7) throw std::runtime_error("test");
+		}), std::runtime_error);
+	}
+
+	BOOST_AUTO_TEST_CASE( thread_count )
+	{
+		BOOST_REQUIRE(default_thread_count() >= 1);
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace utilities_test
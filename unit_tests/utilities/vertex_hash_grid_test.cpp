@@ -0,0 +1,86 @@
+#ifndef BOOST_TEST_MODULE
+#define BOOST_TEST_MODULE vertex_hash_grid_test
+#endif
+
+#include <bso/utilities/vertex_hash_grid.hpp>
+
+#include <stdexcept>
+
+#include <boost/test/included/unit_test.hpp>
+
+/*
+BOOST_TEST()
+BOOST_REQUIRE_THROW(function, std::domain_error)
+BOOST_REQUIRE(!s[8].dominates(s[9]) && !s[9].dominates(s[8]))
+BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+*/
+
+namespace utilities_test {
+using namespace bso::utilities;
+using bso::utilities::geometry::vertex;
+
+BOOST_AUTO_TEST_SUITE( vertex_hash_grid_tests )
+
+	BOOST_AUTO_TEST_CASE( initialization )
+	{
+		vertex_hash_grid g1;
+		BOOST_REQUIRE(g1.size() == 0);
+		BOOST_REQUIRE_THROW(vertex_hash_grid g2(0.0), std::invalid_argument);
+		BOOST_REQUIRE_THROW(vertex_hash_grid g3(-1.0), std::invalid_argument);
+	}
+
+	BOOST_AUTO_TEST_CASE( insert_and_find )
+	{
+		vertex_hash_grid g1;
+		BOOST_REQUIRE(g1.insert(vertex({0,0,0})) == 0);
+		BOOST_REQUIRE(g1.insert(vertex({1000,0,0})) == 1);
+		BOOST_REQUIRE(g1.insert(vertex({1000,-2000,3000})) == 2);
+
+		unsigned long index;
+		BOOST_REQUIRE(g1.find(vertex({1000,-2000,3000}),index));
+		BOOST_REQUIRE(index == 2);
+		BOOST_REQUIRE(g1.find(vertex({1000,0,0}),index));
+		BOOST_REQUIRE(index == 1);
+		BOOST_REQUIRE(!g1.find(vertex({1000,0,1}),index));
+	}
+
+	BOOST_AUTO_TEST_CASE( tolerance_across_cell_borders )
+	{ // a vertex on a cell border must be found from both sides of the border
+		vertex_hash_grid g1(1.0);
+		g1.insert(vertex({1.0,1.0,1.0}));
+
+		unsigned long index;
+		BOOST_REQUIRE(g1.find(vertex({1.0-1e-10,1.0,1.0+1e-10}),index));
+		BOOST_REQUIRE(index == 0);
+		BOOST_REQUIRE(!g1.find(vertex({1.0-1e-8,1.0,1.0}),index));
+		BOOST_REQUIRE(g1.find(vertex({1.0-1e-8,1.0,1.0}),index,1e-7));
+	}
+
+	BOOST_AUTO_TEST_CASE( first_inserted_match )
+	{ // with a large tolerance several vertices match, the first one is returned
+		vertex_hash_grid g1(1.0);
+		g1.insert(vertex({0.6,0,0}));
+		g1.insert(vertex({0.4,0,0}));
+		g1.insert(vertex({1.2,0,0}));
+
+		unsigned long index;
+		BOOST_REQUIRE(g1.find(vertex({1.0,0,0}),index,0.5));
+		BOOST_REQUIRE(index == 0);
+		BOOST_REQUIRE(g1.find(vertex({1.5,0,0}),index,0.5));
+		BOOST_REQUIRE(index == 2);
+		BOOST_REQUIRE(g1.find(vertex({1.0,0,0}),index,10.0));
+		BOOST_REQUIRE(index == 0);
+	}
+
+	BOOST_AUTO_TEST_CASE( clear )
+	{
+		vertex_hash_grid g1;
+		g1.insert(vertex({0,0,0}));
+		g1.clear();
+		unsigned long index;
+		BOOST_REQUIRE(g1.size() == 0);
+		BOOST_REQUIRE(!g1.find(vertex({0,0,0}),index));
+	}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace utilities_test